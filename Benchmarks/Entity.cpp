@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <FrogEngine/Allocator.h>
+#include <FrogEngine/Entity.h>
+
+#include <chrono>
+
+using namespace FrogEngine;
+
+struct Position {
+    f32 x, y, z;
+};
+struct Velocity {
+    f32 x, y, z;
+};
+
+// The object layout the world replaces: every entity a separate heap object with its own
+// unrelated state between the fields a system touches.
+struct GameObject {
+    Position position;
+    u8       state[96];
+    Velocity velocity;
+};
+
+constexpr u32 ENTITY_COUNT { 100'000 };
+constexpr u32 FRAMES { 200 };
+constexpr f32 DELTA { 1.0f / 60.0f };
+
+template <typename Update>
+f64 measure(Update update) {
+    const auto start = std::chrono::steady_clock::now();
+    for (u32 frame = 0; frame < FRAMES; frame++) update();
+    const f64 seconds =
+        std::chrono::duration<f64>(std::chrono::steady_clock::now() - start).count();
+    return seconds * 1e3 / FRAMES;
+}
+
+int main() {
+    Allocator allocator;
+    allocator.init("FROGENGINE-BENCHMARK");
+    registerComponent<Position>();
+    registerComponent<Velocity>();
+
+    World world(&allocator);
+    for (u32 i = 0; i < ENTITY_COUNT; i++)
+        world.create(Position { (f32)i, 0, 0 }, Velocity { 1, 2, 3 });
+
+    // Allocations interleaved with short lived garbage and visited in a shuffled order, like
+    // objects created over the course of a level.
+    static GameObject* objects[ENTITY_COUNT];
+    static void*       garbage[ENTITY_COUNT];
+    for (u32 i = 0; i < ENTITY_COUNT; i++) {
+        objects[i] = new GameObject { { (f32)i, 0, 0 }, {}, { 1, 2, 3 } };
+        garbage[i] = malloc(16 + i % 512);
+    }
+    for (u32 i = 0; i < ENTITY_COUNT; i++) free(garbage[i]);
+    u64 state = 0x9E'37'79'B9'7F'4A'7C'15;
+    for (u32 i = ENTITY_COUNT - 1; i > 0; i--) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        const u32   j = (u32)(state % (i + 1));
+        GameObject* t = objects[i];
+        objects[i]    = objects[j];
+        objects[j]    = t;
+    }
+
+    const f64 world_ms = measure([&world] {
+        world.eachChunk<Position, Velocity>(
+            [](u32 count, const Entity*, Position* positions, Velocity* velocities) {
+                for (u32 i = 0; i < count; i++) {
+                    positions[i].x += velocities[i].x * DELTA;
+                    positions[i].y += velocities[i].y * DELTA;
+                    positions[i].z += velocities[i].z * DELTA;
+                }
+            });
+    });
+    const f64 object_ms = measure([] {
+        for (u32 i = 0; i < ENTITY_COUNT; i++) {
+            GameObject* object  = objects[i];
+            object->position.x += object->velocity.x * DELTA;
+            object->position.y += object->velocity.y * DELTA;
+            object->position.z += object->velocity.z * DELTA;
+        }
+    });
+
+    f64 world_sum = 0, object_sum = 0;
+    world.each<Position>([&world_sum](Entity, Position &position) { world_sum += position.x; });
+    for (u32 i = 0; i < ENTITY_COUNT; i++) object_sum += objects[i]->position.x;
+
+    printf("storage          | entities | ms/frame\n");
+    printf("World chunks     | %8u | %8.3f\n", ENTITY_COUNT, world_ms);
+    printf("Heap GameObjects | %8u | %8.3f\n", ENTITY_COUNT, object_ms);
+    if (world_sum != object_sum) printf("checksum mismatch\n");
+
+    for (u32 i = 0; i < ENTITY_COUNT; i++) delete objects[i];
+    return 0;
+}
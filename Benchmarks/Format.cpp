@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <FrogEngine/Clock.h>
+#include <FrogEngine/Format.h>
+#include <FrogEngine/Runtime.h>
+
+using namespace FrogEngine;
+
+constexpr u32 ROUNDS { 9 };
+constexpr u32 CALLS { 200'000 };
+
+// Keeps the formatted text alive so neither side is optimized away.
+static volatile char sink;
+
+// Nanoseconds per call in the median round.
+template <typename Format>
+f64 measure(Format format) {
+    u64 costs[ROUNDS];
+    for (u32 round = 0; round < ROUNDS; round++) {
+        char      buffer[256];
+        const u64 start = getTime();
+        for (u32 i = 0; i < CALLS; i++) {
+            format(buffer, i);
+            sink = buffer[i & 15];
+        }
+        const u64 cost = getTime() - start;
+        u32       j    = round;
+        for (; j > 0 && costs[j - 1] > cost; j--) costs[j] = costs[j - 1];
+        costs[j] = cost;
+    }
+    return (f64)costs[ROUNDS / 2] / CALLS;
+}
+
+// Values that do not take the digit path, which the timings below never reach. Returns false
+// when the output differs from the C library's.
+static bool checkSpecialValues() {
+    const f64 values[] {
+        __builtin_inf(), -__builtin_inf(), __builtin_nan(""), -__builtin_nan(""), 0.0, -0.0,
+    };
+    bool same = true;
+    for (const f64 value : values) {
+        char engine[64];
+        char libc[64];
+        formatString(
+            engine, sizeof(engine), "[%f|%8.2f|%-6f|%+f|%08f]", value, value, value, value, value);
+        snprintf(libc, sizeof(libc), "[%f|%8.2f|%-6f|%+f|%08f]", value, value, value, value, value);
+        if (strcmp(engine, libc)) {
+            printf("%s differs from %s\n", engine, libc);
+            same = false;
+        }
+    }
+    return same;
+}
+
+int main() {
+    if (!checkSpecialValues()) return 1;
+
+    const char* home = "/home/frog/.local/share";
+
+    const f64 path_engine = measure([&](char* buffer, u32 i) {
+        formatString(buffer, 256, "%s/FrogEngine/%u/engine.cache", home, i);
+    });
+    const f64 path_libc = measure([&](char* buffer, u32 i) {
+        snprintf(buffer, 256, "%s/FrogEngine/%u/engine.cache", home, i);
+    });
+
+    const f64 line_engine = measure([](char* buffer, u32 i) {
+        formatString(
+            buffer,
+            256,
+            "Allocated %zu out of %zu static memory, %5.1f%% used",
+            (usize)i * 4'096,
+            (usize)1 << 24,
+            (f64)i / CALLS * 100);
+    });
+    const f64 line_libc = measure([](char* buffer, u32 i) {
+        snprintf(
+            buffer,
+            256,
+            "Allocated %zu out of %zu static memory, %5.1f%% used",
+            (usize)i * 4'096,
+            (usize)1 << 24,
+            (f64)i / CALLS * 100);
+    });
+
+    const f64 hex_engine = measure([](char* buffer, u32 i) {
+        formatString(buffer, 256, "block %p at %08x", (ptr)((uptr)i << 12), i * 2'654'435'761u);
+    });
+    const f64 hex_libc = measure([](char* buffer, u32 i) {
+        snprintf(buffer, 256, "block %p at %08x", (ptr)((uptr)i << 12), i * 2'654'435'761u);
+    });
+
+    printf("format         | formatString ns | snprintf ns\n");
+    printf("Path           | %15.1f | %11.1f\n", path_engine, path_libc);
+    printf("Log line       | %15.1f | %11.1f\n", line_engine, line_libc);
+    printf("Hex            | %15.1f | %11.1f\n", hex_engine, hex_libc);
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include <stdio.h>
+
+#include <FrogEngine/Clock.h>
+#include <FrogEngine/Runtime.h>
+
+using namespace FrogEngine;
+
+constexpr u32 FRAME_RATE { 120 };
+constexpr u32 FRAMES { 360 };
+constexpr u64 PERIOD { NANOSECONDS_PER_SECOND / FRAME_RATE };
+
+struct Pacing {
+    f64 averageMs;
+    f64 medianErrorMs;
+    f64 tailErrorMs;
+};
+
+// Frame work of varying length, up to half the period.
+static void work(u32 frame) {
+    const u64 end = getTime() + PERIOD / 8 + frame * 7'919 % (PERIOD / 2 - PERIOD / 8);
+    while (getTime() < end) {}
+}
+
+template <typename Wait>
+Pacing measure(Wait wait) {
+    static u64 times[FRAMES + 1];
+    times[0] = getTime();
+    for (u32 frame = 1; frame <= FRAMES; frame++) {
+        work(frame);
+        wait();
+        times[frame] = getTime();
+    }
+
+    // Distance of every frame from the period, sorted for percentiles.
+    static u64 errors[FRAMES];
+    for (u32 frame = 1; frame <= FRAMES; frame++) {
+        const u64 length = times[frame] - times[frame - 1];
+        const u64 error  = length > PERIOD ? length - PERIOD : PERIOD - length;
+        u32       i      = frame - 1;
+        for (; i > 0 && errors[i - 1] > error; i--) errors[i] = errors[i - 1];
+        errors[i] = error;
+    }
+    return {
+        .averageMs     = (f64)(times[FRAMES] - times[0]) * 1e-6 / FRAMES,
+        .medianErrorMs = (f64)errors[FRAMES / 2] * 1e-6,
+        .tailErrorMs   = (f64)errors[FRAMES * 99 / 100] * 1e-6,
+    };
+}
+
+int main() {
+    // The usual loop: sleep for whatever is left of the period after the work.
+    u64          frame_start = getTime();
+    const Pacing naive       = measure([&frame_start] {
+        const u64 elapsed = getTime() - frame_start;
+        if (elapsed < PERIOD) sleepFor(PERIOD - elapsed);
+        frame_start = getTime();
+    });
+
+    FrameLimiter limiter(FRAME_RATE);
+    limiter.wait();
+    const Pacing limited = measure([&limiter] { limiter.wait(); });
+
+    printf("pacing at %u Hz | average ms | median error ms | p99 error ms\n", FRAME_RATE);
+    printf(
+        "sleepFor       | %10.3f | %15.3f | %12.3f\n",
+        naive.averageMs,
+        naive.medianErrorMs,
+        naive.tailErrorMs);
+    printf(
+        "FrameLimiter   | %10.3f | %15.3f | %12.3f\n",
+        limited.averageMs,
+        limited.medianErrorMs,
+        limited.tailErrorMs);
+    printf("spin window    | %.3f ms\n", (f64)limiter.getSpinWindow() * 1e-6);
+    return 0;
+}
@@ -0,0 +1,75 @@
+#include <stdio.h>
+
+#include <FrogEngine/Allocator.h>
+
+#include <chrono>
+
+using namespace FrogEngine;
+
+struct Object {
+    u64 value;
+    u64 padding;
+};
+
+constexpr u32 OBJECT_COUNT { 262'144 };
+constexpr u32 PASSES { 40 };
+
+// References are visited in a shuffled order, like components looked up from gameplay code.
+u32 order[OBJECT_COUNT];
+
+template <typename Resolve>
+f64 measure(Resolve resolve, u64* checksum) {
+    u64        sum   = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (u32 pass = 0; pass < PASSES; pass++)
+        for (u32 i = 0; i < OBJECT_COUNT; i++) sum += resolve(order[i])->value;
+    *checksum = sum;
+    const f64 seconds =
+        std::chrono::duration<f64>(std::chrono::steady_clock::now() - start).count();
+    return seconds * 1e9 / ((f64)PASSES * OBJECT_COUNT);
+}
+
+int main() {
+    Allocator allocator;
+    allocator.init("FROGENGINE-BENCHMARK");
+
+    static Pointer<Object> pointers[OBJECT_COUNT];
+    static Handle<Object>  handles[OBJECT_COUNT];
+    for (u32 i = 0; i < OBJECT_COUNT; i++) {
+        pointers[i]        = allocator.getDynamicBlock()->alloc(sizeof(Object));
+        pointers[i]->value = i;
+        handles[i]         = allocator.createHandle(pointers[i]);
+    }
+
+    u64 state = 0x9E'37'79'B9'7F'4A'7C'15;
+    for (u32 i = 0; i < OBJECT_COUNT; i++) order[i] = i;
+    for (u32 i = OBJECT_COUNT - 1; i > 0; i--) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        const u32 j = (u32)(state % (i + 1));
+        const u32 t = order[i];
+        order[i]    = order[j];
+        order[j]    = t;
+    }
+
+    u64       pointer_sum = 0, handle_sum = 0;
+    const f64 pointer_ns = measure([](u32 i) { return pointers[i].get(); }, &pointer_sum);
+    const f64 handle_ns =
+        measure([&allocator](u32 i) { return allocator.resolve(handles[i]); }, &handle_sum);
+
+    printf("reference  | bytes | total KiB | ns/deref\n");
+    printf(
+        "Pointer<T> | %5zu | %9zu | %8.2f\n",
+        sizeof(Pointer<Object>),
+        sizeof(pointers) / 1'024,
+        pointer_ns);
+    printf(
+        "Handle<T>  | %5zu | %9zu | %8.2f\n",
+        sizeof(Handle<Object>),
+        sizeof(handles) / 1'024,
+        handle_ns);
+    if (pointer_sum != handle_sum) printf("checksum mismatch\n");
+
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include <stdio.h>
+
+#include <FrogEngine/Allocator.h>
+#include <FrogEngine/HashMap.h>
+
+#include <chrono>
+#include <unordered_map>
+
+using namespace FrogEngine;
+
+constexpr u64 SIZES[] { 1'000, 10'000, 100'000, 1'000'000, 10'000'000 };
+constexpr u64 MAX_SIZE { 10'000'000 };
+
+// Keys are scrambled so neither map sees them in order. Missing keys come from the same stream
+// past the inserted ones.
+u64 keys[MAX_SIZE * 2];
+
+template <typename Function>
+f64 measure(u64 count, Function function) {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    const f64 seconds =
+        std::chrono::duration<f64>(std::chrono::steady_clock::now() - start).count();
+    return seconds * 1e9 / (f64)count;
+}
+
+int main() {
+    Allocator allocator;
+    allocator.init("FROGENGINE-BENCHMARK");
+
+    u64 state = 0x9E'37'79'B9'7F'4A'7C'15;
+    for (u64 i = 0; i < MAX_SIZE * 2; i++) {
+        state   ^= state << 13;
+        state   ^= state >> 7;
+        state   ^= state << 17;
+        keys[i]  = state;
+    }
+
+    printf("container          |    entries | insert ns | hit ns | miss ns\n");
+    for (const u64 entries : SIZES) {
+        const u64* misses = keys + MAX_SIZE;
+        u64        sum    = 0;
+
+        {
+            HashMap<u64, u64> map(allocator.getDynamicBlock());
+            const f64         insert_ns = measure(entries, [&] {
+                for (u64 i = 0; i < entries; i++) map.insert(keys[i], i);
+            });
+            const f64         hit_ns    = measure(entries, [&] {
+                for (u64 i = 0; i < entries; i++) sum += *map.find(keys[i]);
+            });
+            const f64         miss_ns   = measure(entries, [&] {
+                for (u64 i = 0; i < entries; i++) sum += map.contains(misses[i]);
+            });
+            printf(
+                "HashMap            | %10llu | %9.2f | %6.2f | %7.2f\n",
+                (unsigned long long)entries,
+                insert_ns,
+                hit_ns,
+                miss_ns);
+        }
+        {
+            std::unordered_map<u64, u64> map;
+            const f64                    insert_ns = measure(entries, [&] {
+                for (u64 i = 0; i < entries; i++) map[keys[i]] = i;
+            });
+            const f64                    hit_ns    = measure(entries, [&] {
+                for (u64 i = 0; i < entries; i++) sum += map.find(keys[i])->second;
+            });
+            const f64                    miss_ns   = measure(entries, [&] {
+                for (u64 i = 0; i < entries; i++) sum += map.count(misses[i]);
+            });
+            printf(
+                "std::unordered_map | %10llu | %9.2f | %6.2f | %7.2f\n",
+                (unsigned long long)entries,
+                insert_ns,
+                hit_ns,
+                miss_ns);
+        }
+        // Keeps the lookups from being optimized away.
+        if (sum == 1) printf("\n");
+    }
+
+    return 0;
+}
@@ -0,0 +1,53 @@
+#include <stdio.h>
+
+#include <FrogEngine/Allocator.h>
+
+#include <chrono>
+
+using namespace FrogEngine;
+
+constexpr usize REGION_SIZE { 1'073'741'824 };
+constexpr u32   ACCESSES { 50'000'000 };
+
+// Dependent random reads over the whole region so every access is a likely TLB miss.
+f64 randomAccess(const u64* data, usize count, u64* checksum) {
+    u64        state = 0x9E'37'79'B9'7F'4A'7C'15;
+    u64        sum   = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (u32 i = 0; i < ACCESSES; i++) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        sum   += data[(state + sum) % count];
+    }
+    *checksum = sum;
+    return std::chrono::duration<f64>(std::chrono::steady_clock::now() - start).count();
+}
+
+void run(AllocatorPages pages) {
+    Allocator allocator;
+    allocator.init("FROGENGINE-BENCHMARK", pages);
+
+    const Pointer<u8> region = allocator.getDynamicBlock()->alloc(REGION_SIZE);
+    u64*              data   = (u64*)region.get();
+    const usize       count  = REGION_SIZE / sizeof(u64);
+    for (usize i = 0; i < count; i++) data[i] = i;
+
+    constexpr const char* PAGE_NAMES[] = { "normal", "transparent huge", "huge" };
+    u64                   checksum     = 0;
+    const f64             seconds      = randomAccess(data, count, &checksum);
+    printf(
+        "requested %-16s | got %-16s | %6.2f ns/access | %7.1f MB/s (%llu)\n",
+        PAGE_NAMES[pages],
+        PAGE_NAMES[allocator.getPages()],
+        seconds * 1e9 / ACCESSES,
+        ACCESSES * sizeof(u64) / seconds / 1e6,
+        (unsigned long long)checksum);
+}
+
+int main() {
+    run(PAGES_DEFAULT);
+    run(PAGES_TRANSPARENT_HUGE);
+    run(PAGES_HUGE);
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include <stdio.h>
+
+#include <FrogEngine/Allocator.h>
+#include <FrogEngine/Job.h>
+#include <FrogEngine/Thread.h>
+
+#include <chrono>
+
+using namespace FrogEngine;
+
+constexpr u32 ELEMENT_COUNT { 4'000'000 };
+constexpr u32 SMALL_JOB_COUNT { 100'000 };
+constexpr u32 ROUNDS { 10 };
+
+// A few dozen cycles of dependent math per element, so the loop is bound by compute rather
+// than memory bandwidth and can scale with cores.
+static f32 simulate(f32 value) {
+    for (u32 i = 0; i < 16; i++) value = value * 0.999f + 0.5f / (1.0f + value * value);
+    return value;
+}
+
+template <typename Work>
+f64 measure(Work work) {
+    const auto start = std::chrono::steady_clock::now();
+    for (u32 round = 0; round < ROUNDS; round++) work();
+    const f64 seconds =
+        std::chrono::duration<f64>(std::chrono::steady_clock::now() - start).count();
+    return seconds * 1e3 / ROUNDS;
+}
+
+int main() {
+    Allocator allocator;
+    allocator.init("FROGENGINE-BENCHMARK");
+
+    static f32 values[ELEMENT_COUNT];
+    for (u32 i = 0; i < ELEMENT_COUNT; i++) values[i] = (f32)(i % 1'000) * 0.01f;
+
+    const u32 core_count = getCoreCount();
+    f64       base_for = 0, base_small = 0;
+
+    printf("workers | parallelFor ms | speedup | small jobs ms | speedup\n");
+    for (u32 workers = 1; workers <= core_count; workers *= 2) {
+        JobSystem jobs(&allocator);
+        jobs.init(workers);
+
+        const f64 for_ms = measure([&jobs] {
+            jobs.parallelFor(ELEMENT_COUNT, [](u32 begin, u32 end) {
+                for (u32 i = begin; i < end; i++) values[i] = simulate(values[i]);
+            });
+        });
+        // Many tiny jobs measure scheduling overhead rather than the work itself.
+        const f64 small_ms = measure([&jobs] {
+            static u32 sums[JOB_MAX_WORKERS * 16];
+            JobCounter counter;
+            for (u32 i = 0; i < SMALL_JOB_COUNT; i++)
+                jobs.run([&jobs] { sums[jobs.getWorkerIndex() * 16]++; }, &counter);
+            jobs.wait(&counter);
+        });
+
+        if (workers == 1) base_for = for_ms, base_small = small_ms;
+        printf(
+            "%7u | %14.3f | %6.2fx | %13.3f | %6.2fx\n",
+            workers,
+            for_ms,
+            base_for / for_ms,
+            small_ms,
+            base_small / small_ms);
+
+        if (workers < core_count && workers * 2 > core_count) workers = core_count / 2;
+    }
+    return 0;
+}
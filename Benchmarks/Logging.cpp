@@ -0,0 +1,119 @@
+#define FR_LOG
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <FrogEngine/Clock.h>
+#include <FrogEngine/Log.h>
+#include <FrogEngine/LogFile.h>
+#include <FrogEngine/Runtime.h>
+
+using namespace FrogEngine;
+
+constexpr u32 FRAMES { 200 };
+constexpr u32 LINES_PER_FRAME { 50 };
+constexpr u32 LINES { FRAMES * LINES_PER_FRAME };
+
+// What logInfo() did before it queued: format and write on the calling thread.
+static void logInfoSync(const char* format, ...) {
+    char    line[LOG_LINE_SIZE];
+    va_list args;
+    va_start(args, format);
+    const usize length = formatLogLine(
+        line,
+        FR_LOG_FORMAT_GREEN "[INFO] " FR_LOG_FORMAT_RESET,
+        FR_LOG_FORMAT_RESET "\n",
+        format,
+        args);
+    va_end(args);
+    writeFile(FILE_OUTPUT, line, length);
+}
+
+// Nanoseconds the calling thread spends per line, in the median frame so a frame where the
+// logger thread preempted the caller does not count. The frame gap gives the logger time to
+// drain, the way a real frame would.
+template <typename Log>
+f64 measure(Log log) {
+    static u64 costs[FRAMES];
+    for (u32 frame = 0; frame < FRAMES; frame++) {
+        const u64 start = getTime();
+        for (u32 i = 0; i < LINES_PER_FRAME; i++) log(frame, i);
+        const u64 cost = getTime() - start;
+        u32       j    = frame;
+        for (; j > 0 && costs[j - 1] > cost; j--) costs[j] = costs[j - 1];
+        costs[j] = cost;
+        sleepFor(2 * NANOSECONDS_PER_MILLISECOND);
+    }
+    return (f64)costs[FRAMES / 2] / LINES_PER_FRAME;
+}
+
+// What the messages of a log file take on disk: the format table, and the records of every
+// block with the block headers.
+static f64 measureLogFile(const char* path) {
+    FILE* file = fopen(path, "rb");
+    fseek(file, 0, SEEK_END);
+    const long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    u8* data = (u8*)malloc((usize)size);
+    fread(data, 1, (usize)size, file);
+    fclose(file);
+
+    const LogFileHeader* header = (const LogFileHeader*)data;
+    u64                  bytes  = header->tableUsed;
+    for (u32 i = 0; i < header->blockCount; i++) {
+        const LogFileBlock* block = (const LogFileBlock*)(data + LOG_FILE_HEADER_SIZE
+                                                          + header->tableSize
+                                                          + (usize)i * header->blockSize);
+        if (block->sequence) bytes += sizeof(LogFileBlock) + block->used;
+    }
+    free(data);
+    return (f64)bytes;
+}
+
+int main() {
+    // /dev/null is the cheapest sink there is, a terminal or a file only widens the gap.
+    fflush(stdout);
+    const int terminal = dup(1);
+    dup2(open("/dev/null", O_WRONLY), 1);
+
+    const f64 sync = measure([](u32 frame, u32 i) {
+        logInfoSync("%sBENCH%s: frame %u line %u at %.3f ms", "", "", frame, i, frame * 16.6);
+    });
+    const f64 async = measure([](u32 frame, u32 i) {
+        logInfo("%sBENCH%s: frame %u line %u at %.3f ms", "", "", frame, i, frame * 16.6);
+    });
+    const u64 start = getTime();
+    flushLog();
+    const f64 flush_us = (f64)(getTime() - start) * 1e-3;
+
+    // A soak run's usual traffic, to a real file as text and as binary records.
+    const auto trace = [](u32 frame, u32 i) {
+        FR_LOG_INFO(
+            ALLOCATOR,
+            "Allocated %zu out of %zu static memory",
+            (usize)frame * 4'096 + i,
+            (usize)1 << 24);
+    };
+    const int text_file = open("BenchLogging.log", O_RDWR | O_CREAT | O_TRUNC, 0644);
+    dup2(text_file, 1);
+    const f64 text = measure(trace);
+    flushLog();
+    const f64 text_bytes = (f64)lseek(text_file, 0, SEEK_END) / LINES;
+
+    openLogFile("BenchLogging.frlog", 16 << 20);
+    const f64 binary = measure(trace);
+    closeLogFile();
+    const f64 binary_bytes = measureLogFile("BenchLogging.frlog") / LINES;
+
+    dup2(terminal, 1);
+    printf("logging path   | caller ns/line\n");
+    printf("Synchronous    | %14.1f\n", sync);
+    printf("Queued         | %14.1f\n", async);
+    printf("final flush    | %.1f us\n", flush_us);
+    printf("\nlog file       | caller ns/line | bytes/line\n");
+    printf("Text           | %14.1f | %10.1f\n", text, text_bytes);
+    printf("Binary         | %14.1f | %10.1f\n", binary, binary_bytes);
+    return 0;
+}
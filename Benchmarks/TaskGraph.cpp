@@ -0,0 +1,60 @@
+#include <stdio.h>
+
+#include <FrogEngine/Allocator.h>
+#include <FrogEngine/Job.h>
+#include <FrogEngine/Runtime.h>
+#include <FrogEngine/TaskGraph.h>
+
+using namespace FrogEngine;
+
+constexpr u32 FRAMES { 500 };
+
+// Stage costs in microseconds, roughly the shape of a game frame.
+enum Stage : u32 { INPUT, SIMULATION, CULLING, COMMANDS, AUDIO, PRESENT, STAGE_COUNT };
+constexpr u64 STAGE_COST[STAGE_COUNT] { 100, 2'000, 800, 1'200, 1'500, 1'000 };
+
+static void spin(u64 microseconds) {
+    const u64 end = getTime() + microseconds * 1'000;
+    while (getTime() < end) {}
+}
+
+int main() {
+    Allocator allocator;
+    allocator.init("FROGENGINE-BENCHMARK");
+    JobSystem jobs(&allocator);
+    jobs.init();
+
+    u64 start = getTime();
+    for (u32 frame = 0; frame < FRAMES; frame++)
+        for (u32 stage = 0; stage < STAGE_COUNT; stage++) spin(STAGE_COST[stage]);
+    const f64 serial_ms = (f64)(getTime() - start) * 1e-6 / FRAMES;
+
+    // Simulation reads last frame's input and writes the world; present only reads the
+    // command buffer, so it overlaps the next frame's simulation.
+    TaskGraph          graph(&jobs);
+    const ResourceMask input    = graph.addResource();
+    const ResourceMask world    = graph.addResource();
+    const ResourceMask visible  = graph.addResource();
+    const ResourceMask commands = graph.addResource();
+    const ResourceMask mixer    = graph.addResource();
+    const ResourceMask display  = graph.addResource();
+    graph.addTask("input", 0, input, [](u64) { spin(STAGE_COST[INPUT]); });
+    graph.addTask("simulation", input, world, [](u64) { spin(STAGE_COST[SIMULATION]); });
+    graph.addTask("culling", world, visible, [](u64) { spin(STAGE_COST[CULLING]); });
+    graph.addTask("commands", world | visible, commands, [](u64) { spin(STAGE_COST[COMMANDS]); });
+    graph.addTask("audio", world, mixer, [](u64) { spin(STAGE_COST[AUDIO]); });
+    graph.addTask("present", commands, display, [](u64) { spin(STAGE_COST[PRESENT]); });
+    graph.build();
+
+    start = getTime();
+    for (u32 frame = 0; frame < FRAMES; frame++) graph.beginFrame();
+    graph.waitFrames();
+    const f64 graph_ms = (f64)(getTime() - start) * 1e-6 / FRAMES;
+
+    graph.logTimings();
+    printf("schedule           | workers | ms/frame\n");
+    printf("Serial stages      | %7u | %8.3f\n", 1, serial_ms);
+    printf("Pipelined graph    | %7u | %8.3f\n", jobs.getWorkerCount(), graph_ms);
+    printf("Critical path      |         | %8.3f\n", graph.getCriticalPathMs());
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include <stdio.h>
+
+#include <FrogEngine/Allocator.h>
+
+#include <chrono>
+#include <thread>
+
+using namespace FrogEngine;
+
+struct Object {
+    u64 data[6];
+};
+
+constexpr u32 ROUNDS { 20'000 };
+constexpr u32 BATCH { 48 };
+
+// Allocates a batch of objects, touches them and frees them again, like per frame scratch
+// objects in gameplay code.
+template <typename Source>
+void churn(Source* source) {
+    Pointer<Object> objects[BATCH];
+    for (u32 round = 0; round < ROUNDS; round++) {
+        for (u32 i = 0; i < BATCH; i++) {
+            objects[i]          = source->template alloc<Object>();
+            objects[i]->data[0] = round;
+        }
+        for (u32 i = 0; i < BATCH; i++) source->free(objects[i]);
+    }
+}
+
+f64 runShared(Allocator* allocator, u32 thread_count) {
+    std::thread threads[256];
+    const auto  start = std::chrono::steady_clock::now();
+    for (u32 i = 0; i < thread_count; i++)
+        threads[i] = std::thread([allocator] { churn(allocator->getPoolBlock()); });
+    for (u32 i = 0; i < thread_count; i++) threads[i].join();
+    return std::chrono::duration<f64>(std::chrono::steady_clock::now() - start).count();
+}
+
+f64 runCached(Allocator* allocator, u32 thread_count) {
+    std::thread threads[256];
+    const auto  start = std::chrono::steady_clock::now();
+    for (u32 i = 0; i < thread_count; i++)
+        threads[i] = std::thread([allocator] {
+            ThreadCache cache(allocator);
+            churn(&cache);
+        });
+    for (u32 i = 0; i < thread_count; i++) threads[i].join();
+    return std::chrono::duration<f64>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    Allocator allocator;
+    allocator.init("FROGENGINE-BENCHMARK");
+
+    u32 max_threads = std::thread::hardware_concurrency();
+    if (max_threads == 0) max_threads = 4;
+    if (max_threads > 256) max_threads = 256;
+
+    // Warm up so slab creation is not part of the measurement.
+    runCached(&allocator, max_threads);
+
+    printf("threads | shared pool Mops/s | thread cache Mops/s\n");
+    for (u32 thread_count = 1; thread_count <= max_threads; thread_count *= 2) {
+        const f64 operations = 2.0 * ROUNDS * BATCH * thread_count / 1'000'000.0;
+        const f64 shared     = runShared(&allocator, thread_count);
+        const f64 cached     = runCached(&allocator, thread_count);
+        printf("%7u | %18.1f | %19.1f\n", thread_count, operations / shared, operations / cached);
+    }
+
+    return 0;
+}
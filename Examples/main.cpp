@@ -1,10 +1,14 @@
 #include <FrogEngine/Allocator.h>
+#include <FrogEngine/Clock.h>
 #include <FrogEngine/Log.h>
 #include <FrogEngine/Save.h>
 #include <FrogEngine/Window.h>
 
 using namespace FrogEngine;
 
+constexpr u32 FRAME_RATE { 60 };
+constexpr u32 TICK_RATE { 120 };
+
 int main() {
     Allocator allocator;
     allocator.init("FROGENGINE-EXAMPLE");
@@ -23,7 +27,16 @@ int main() {
 
     window.startTextInput();
 
+    FrameLimiter limiter(FRAME_RATE);
+    FixedStep    simulation(NANOSECONDS_PER_SECOND / TICK_RATE);
+
     while (window.pollEvents()) {
+        const u32 ticks = simulation.advance(limiter.wait());
+        for (u32 i = 0; i < ticks; i++) {
+            // Game logic steps by simulation.getStepSeconds() here, at TICK_RATE however long
+            // frames take. Rendering then blends the last two ticks by simulation.getAlpha().
+        }
+
         if (window.getKeyPress() & KEY_ESCAPE) {
             window.close();
             break;
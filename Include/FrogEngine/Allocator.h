@@ -1,12 +1,171 @@
 #ifndef FROGENGINE_ALLOCATOR_H
 #define FROGENGINE_ALLOCATOR_H
 
+#include <string.h>
+
+#include <FrogEngine/Atomic.h>
+#include <FrogEngine/Clock.h>
+#include <FrogEngine/Handle.h>
+#include <FrogEngine/Log.h>
 #include <FrogEngine/Pointer.h>
+#include <FrogEngine/Shadow.h>
 #include <FrogEngine/Utility.h>
 
+#include <new>
+
 namespace FrogEngine {
     class Allocator;
 
+    constexpr usize CACHE_LINE_SIZE { 64 };
+
+    constexpr bool  isPowerOfTwo(usize value) { return value && !(value & value - 1); }
+    constexpr usize alignUp(usize value, usize alignment) {
+        return value + alignment - 1 & ~(alignment - 1);
+    }
+
+    // Types that can be moved with memcpy, like realloc() and compaction do. Only these can be
+    // constructed in allocator memory.
+    template <typename T>
+    struct IsRelocatable {
+        static constexpr bool value = __is_trivially_copyable(T);
+    };
+
+    // Placement construction of `count` elements, each from the same arguments.
+    template <typename T, typename... Args>
+    void construct(Pointer<T> pointer, usize count, const Args &...args) {
+        static_assert(IsRelocatable<T>::value, "Type can not be moved by the allocator");
+        T* const elements = pointer.get();
+        for (usize i = 0; i < count; i++) new (elements + i) T(args...);
+    }
+    template <typename T>
+    void destroy(Pointer<T> pointer, usize count) {
+        static_assert(IsRelocatable<T>::value, "Type can not be moved by the allocator");
+        T* const elements = pointer.get();
+        for (usize i = 0; i < count; i++) elements[i].~T();
+    }
+
+    // Owner of an allocation. Applications can add their own tags from TAG_USER up to
+    // ALLOC_TAG_COUNT.
+    enum AllocTag : u8 {
+        TAG_GENERAL = 0, ///< Untagged memory
+        TAG_POOL    = 1, ///< Slabs taken by PoolBlock
+        TAG_WINDOW  = 2, ///< Window module
+        TAG_SAVE    = 3, ///< Save module
+        TAG_STRING  = 4, ///< Interned strings
+        TAG_ENTITY  = 5, ///< Entity records and archetypes
+        TAG_JOB     = 6, ///< Job pool and worker deques
+        TAG_USER    = 7, ///< First application tag
+    };
+    constexpr u32 ALLOC_TAG_COUNT { 16 };
+
+    struct TagStats {
+        usize live {};
+        usize peak {};
+        usize calls {};
+    };
+
+    // Per tag counters for static and dynamic memory. They are only updated when FR_DEBUG or
+    // FR_MEMORY_PROFILE is defined, otherwise every hook compiles away and the stats stay empty.
+    // Counters are atomic because dynamic memory is shared between threads.
+    class MemoryProfile {
+      public:
+        void onAlloc(AllocTag tag, usize _size);
+        void onResize(AllocTag tag, usize _old, usize _new);
+        void onFree(AllocTag tag, usize _size);
+
+        TagStats getStats(AllocTag tag) const;
+        void     logStats() const;
+
+      private:
+        TagStats tags[ALLOC_TAG_COUNT];
+    };
+
+    const char* getTagName(AllocTag tag);
+
+    constexpr usize DYNAMIC_ALIGN { 16 };
+    constexpr u32   DYNAMIC_FIRST_COUNT { 32 };
+    constexpr u32   DYNAMIC_SECOND_COUNT { 16 };
+    // Time FrameBlock::swap() gives DynamicBlock::compact() every frame.
+    constexpr u64 DYNAMIC_COMPACT_BUDGET { 100 * NANOSECONDS_PER_MICROSECOND };
+
+    constexpr u32 RELOCATION_NONE { ~0u };
+    constexpr u32 RELOCATION_MAX_COUNT { HANDLE_INDEX_MASK };
+
+    // Movable allocations are reached through `address`, which compaction patches whenever it
+    // moves the block. `generation` is bumped every time the entry is released.
+    struct RelocationEntry {
+        uptr address {};
+        u32  pins {};
+        u32  generation {};
+    };
+
+    // Indirection table for movable dynamic memory and handles. Entries live in their own
+    // reserved range, so their addresses stay valid while the table grows. Released entries are
+    // reused first. acquire() and release() take a spin lock; resolve() takes none.
+    class RelocationTable {
+      public:
+        RelocationTable();
+        ~RelocationTable();
+
+        u32  acquire(uptr address);
+        void release(u32 index);
+
+        // Returns nullptr for null and stale handles.
+        template <typename T>
+        T* resolve(Handle<T> handle) const {
+            const u32 index = handle.getIndex();
+            if (index >= count
+                || (entries[index].generation & HANDLE_GENERATION_MASK) != handle.getGeneration())
+                return nullptr;
+            return (T*)entries[index].address;
+        }
+        template <typename T>
+        bool isValid(Handle<T> handle) const {
+            return resolve(handle) != nullptr;
+        }
+        template <typename T>
+        Handle<T> getHandle(u32 index) const {
+            return Handle<T>(index, entries[index].generation);
+        }
+
+        RelocationEntry* getEntry(u32 index);
+        u32              getIndex(const RelocationEntry* entry) const;
+        u32              getCount() const;
+
+      private:
+        SpinLock lock;
+
+        RelocationEntry* entries { nullptr };
+        u32              count {};
+        u32              committed {};
+        u32              freeList { RELOCATION_NONE };
+    };
+
+    struct CompactStats {
+        usize bytesMoved {};  ///< Moved by the last compact() call, normally the last frame
+        usize blocksMoved {}; ///< Moved by the last compact() call, normally the last frame
+        usize totalBytesMoved {};
+        usize totalBlocksMoved {};
+    };
+
+    struct DynamicStats {
+        usize size {};
+        usize used {};
+        usize free {};
+        usize largestFree {};
+        usize blocks {};
+        usize freeBlocks {};
+        f32   fragmentation {}; ///< 1 - largestFree / free
+    };
+
+    // Called for every block in address order by DynamicBlock::walk().
+    typedef void (*DynamicVisitor)(ptr user, usize offset, usize _size, AllocTag tag, bool free);
+
+    // Two-level segregated fit (TLSF) allocator over the dynamic region. Block headers and free
+    // list links are stored as offsets from the start of the region. alloc(), realloc() and
+    // dealloc() are guarded by a spin lock. The tag of a block is kept in its header, so realloc()
+    // and dealloc() do not need it. Payloads are 16 byte aligned; larger power of two alignments
+    // split the front of a free block off.
     class DynamicBlock {
       public:
         DynamicBlock(Allocator* _allocator);
@@ -14,15 +173,224 @@ namespace FrogEngine {
 
         void        init(ptr _buffer, usize _size);
         void        resize(usize _size);
-        Pointer<u8> alloc(usize _size);
-        Pointer<u8> realloc(Pointer<u8> pointer, usize _old, usize _new);
-        void        dealloc(Pointer<u8> pointer, usize _size);
+        Pointer<u8> alloc(usize _size, AllocTag tag = TAG_GENERAL);
+        Pointer<u8> allocAligned(usize _size, usize alignment, AllocTag tag = TAG_GENERAL);
+        Pointer<u8> realloc(
+            Pointer<u8> pointer, usize _old, usize _new, usize alignment = DYNAMIC_ALIGN);
+        void dealloc(Pointer<u8> pointer, usize _size);
+
+        template <typename T>
+        Pointer<T> alloc(usize count, usize alignment = alignof(T), AllocTag tag = TAG_GENERAL) {
+            return allocAligned(
+                count * sizeof(T), alignment > DYNAMIC_ALIGN ? alignment : DYNAMIC_ALIGN, tag);
+        }
+        // Whole cache lines, so nothing else shares a line with the elements.
+        template <typename T>
+        Pointer<T> allocIsolated(usize count, AllocTag tag = TAG_GENERAL) {
+            return allocAligned(alignUp(count * sizeof(T), CACHE_LINE_SIZE), CACHE_LINE_SIZE, tag);
+        }
+        template <typename T>
+        void dealloc(Pointer<T> pointer, usize count) {
+            dealloc(Pointer<u8>(pointer), count * sizeof(T));
+        }
+
+#ifndef FR_STABLE_POINTER
+        // Movable memory is reached through the relocation table, so compact() can slide it
+        // down to close holes. Raw addresses taken from these pointers are only valid until the
+        // next compact() unless the allocation is pinned.
+        Pointer<u8> allocMovable(usize _size, AllocTag tag = TAG_GENERAL);
+        void        deallocMovable(Pointer<u8> pointer);
+        void        pin(Pointer<u8> pointer);
+        void        unpin(Pointer<u8> pointer);
+        Handle<u8>  getHandle(Pointer<u8> pointer);
+
+        // Moves movable blocks down into the holes before them until `budget` nanoseconds have
+        // passed. The walk looks at the clock every few blocks and before each move, so only one
+        // large block can overrun it. The next call resumes the walk where this one stopped.
+        // FrameBlock::swap() calls it once per frame.
+        CompactStats compact(u64 budget);
+        CompactStats getCompactStats() const;
+#endif
+
+        DynamicStats getStats();
+        void         logStats();
+        void         walk(DynamicVisitor visit, ptr user);
+
+        void setBuffer(ptr _buffer);
+
+        const ptr getBuffer() const;
+        uptr*     getBase();
+        usize     getSize() const;
+        usize     getUsed() const;
+        usize     getPeak() const;
 
       private:
+        usize allocBlock(usize _size, AllocTag tag, usize alignment);
+        usize alignBlock(usize block, usize alignment);
+        void  freeBlock(usize block);
+        void  trackPeak(usize block);
+        void  insertFree(usize block);
+        void  removeFree(usize block);
+        usize findFree(usize _size) const;
+        void  splitBlock(usize block, usize _size);
+        usize mergeBlock(usize block);
+        usize slideBlock(usize block);
+        void  grow(usize _size);
+#ifndef FR_STABLE_POINTER
+        u32 getMovableIndex(Pointer<u8> pointer);
+#endif
+
         Allocator* allocator { nullptr };
+        SpinLock   lock;
 
         ptr   buffer { nullptr };
         usize size {};
+        usize used {};
+        usize peak {};
+
+        CompactStats compactStats {};
+        usize        compactCursor {}; ///< Block the next compact() call starts from
+
+        u32   firstMap {};
+        u32   secondMap[DYNAMIC_FIRST_COUNT] {};
+        usize freeLists[DYNAMIC_FIRST_COUNT][DYNAMIC_SECOND_COUNT] {};
+    };
+
+    constexpr u32   POOL_CLASS_COUNT { 5 };
+    constexpr usize POOL_MIN_SIZE { 16 };
+    constexpr usize POOL_MAX_SIZE { POOL_MIN_SIZE << (POOL_CLASS_COUNT - 1) };
+    constexpr usize POOL_SLAB_SIZE { 16'384 };
+    constexpr usize POOL_CHUNK_SIZE { POOL_SLAB_SIZE };
+
+    // Size class index for an object of `_size` bytes, rounding up to the next power of two.
+    constexpr u32 getPoolClass(usize _size) {
+        return _size <= POOL_MIN_SIZE ? 0 : 1 + getPoolClass((_size + 1) / 2);
+    }
+
+    // Shadow state of pool slots. Free slots keep their free list link readable.
+    inline void markSlotUsed(ptr slot, usize _size, usize slot_size) {
+        unpoisonMemory(slot, _size);
+        poisonMemory((u8*)slot + _size, slot_size - _size, SHADOW_REDZONE);
+    }
+    inline void markSlotFree(ptr slot, usize _size, usize slot_size) {
+#ifdef FR_MEMORY_POISON
+        memset(slot, SHADOW_FREED_PATTERN, _size);
+#endif
+        poisonMemory(slot, slot_size, SHADOW_FREED, sizeof(usize));
+    }
+
+    struct PoolStats {
+        usize slotSize {};
+        usize slabs {};
+        usize used {};
+        usize capacity {};
+    };
+
+    // Size class slab allocator for small objects. Slabs are taken from dynamic memory and every
+    // slab only holds slots of one size, with free slots linked through their first bytes.
+    // Every call takes a spin lock; threads should go through a ThreadCache instead.
+    //
+    // Whole slabs are also handed out as chunks for containers that lay out their own data, like
+    // the entity world. Freed chunks are kept for reuse instead of going back to dynamic memory.
+    class PoolBlock {
+      public:
+        PoolBlock(Allocator* _allocator);
+        ~PoolBlock();
+
+        template <typename T>
+        Pointer<T> alloc() {
+            static_assert(sizeof(T) <= POOL_MAX_SIZE, "Type is too large for pool memory");
+            constexpr u32 pool_class = getPoolClass(sizeof(T));
+            const usize   offset     = allocSlot(pool_class);
+            markSlotUsed((ptr)(*base + offset), sizeof(T), POOL_MIN_SIZE << pool_class);
+            return Pointer<T>(offset, base, 1, allocatorBuffer, 0);
+        }
+        template <typename T>
+        void free(Pointer<T> pointer) {
+            static_assert(sizeof(T) <= POOL_MAX_SIZE, "Type is too large for pool memory");
+            constexpr u32 pool_class = getPoolClass(sizeof(T));
+            markSlotFree(pointer.get(), sizeof(T), POOL_MIN_SIZE << pool_class);
+            freeSlot(pool_class, pointer.getOffset());
+        }
+
+        // Moves `count` slots of a class in or out of the pool under a single lock.
+        void allocBatch(u32 pool_class, usize* offsets, u32 count);
+        void freeBatch(u32 pool_class, const usize* offsets, u32 count);
+
+        // POOL_CHUNK_SIZE bytes aligned to POOL_MAX_SIZE. Not zeroed.
+        Pointer<u8> allocChunk();
+        void        freeChunk(Pointer<u8> chunk);
+
+        PoolStats getStats(u32 pool_class) const;
+        PoolStats getChunkStats() const;
+        void      logStats() const;
+
+      private:
+        struct PoolClass {
+            usize freeList {};
+            usize next {};
+            usize end {};
+            usize used {};
+            usize slabs {};
+        };
+
+        usize allocSlot(u32 pool_class);
+        void  freeSlot(u32 pool_class, usize offset);
+        usize popSlot(u32 pool_class);
+        void  pushSlot(u32 pool_class, usize offset);
+
+        Allocator* allocator { nullptr };
+        uptr*      base { nullptr };
+        ptr*       allocatorBuffer { nullptr };
+        SpinLock   lock;
+
+        PoolClass classes[POOL_CLASS_COUNT];
+        PoolClass chunks;
+    };
+
+    constexpr u32 THREAD_CACHE_SIZE { 64 };
+
+    // Per thread magazines of pool slots. alloc() and free() only touch the owning thread's
+    // magazines and refill or flush them in batches, so the fast path uses no atomics. Create
+    // one per thread and never share it; the destructor returns cached slots to the pool.
+    class ThreadCache {
+      public:
+        explicit ThreadCache(Allocator* _allocator);
+        ~ThreadCache();
+
+        ThreadCache(const ThreadCache &)            = delete;
+        ThreadCache &operator=(const ThreadCache &) = delete;
+
+        template <typename T>
+        Pointer<T> alloc() {
+            static_assert(sizeof(T) <= POOL_MAX_SIZE, "Type is too large for pool memory");
+            constexpr u32 pool_class = getPoolClass(sizeof(T));
+            if (!counts[pool_class]) refill(pool_class);
+            const usize offset = slots[pool_class][--counts[pool_class]];
+            markSlotUsed((ptr)(*base + offset), sizeof(T), POOL_MIN_SIZE << pool_class);
+            return Pointer<T>(offset, base, 1, allocatorBuffer, 0);
+        }
+        template <typename T>
+        void free(Pointer<T> pointer) {
+            static_assert(sizeof(T) <= POOL_MAX_SIZE, "Type is too large for pool memory");
+            constexpr u32 pool_class = getPoolClass(sizeof(T));
+            markSlotFree(pointer.get(), sizeof(T), POOL_MIN_SIZE << pool_class);
+            if (counts[pool_class] == THREAD_CACHE_SIZE) flush(pool_class, THREAD_CACHE_SIZE / 2);
+            slots[pool_class][counts[pool_class]++] = pointer.getOffset();
+        }
+
+        void flush();
+
+      private:
+        void refill(u32 pool_class);
+        void flush(u32 pool_class, u32 count);
+
+        PoolBlock* poolBlock { nullptr };
+        uptr*      base { nullptr };
+        ptr*       allocatorBuffer { nullptr };
+
+        u32   counts[POOL_CLASS_COUNT] {};
+        usize slots[POOL_CLASS_COUNT][THREAD_CACHE_SIZE];
     };
 
     class StaticBlock {
@@ -30,20 +398,108 @@ namespace FrogEngine {
         StaticBlock(Allocator* _allocator);
         ~StaticBlock();
 
+        void        init(ptr _buffer, usize _size);
+        Pointer<u8> alloc(usize _size, AllocTag tag = TAG_GENERAL);
+        Pointer<u8> allocAligned(usize _size, usize alignment, AllocTag tag = TAG_GENERAL);
+
+        template <typename T>
+        Pointer<T> alloc(usize count, usize alignment = alignof(T), AllocTag tag = TAG_GENERAL) {
+            return allocAligned(count * sizeof(T), alignment, tag);
+        }
+        template <typename T>
+        Pointer<T> allocIsolated(usize count, AllocTag tag = TAG_GENERAL) {
+            return allocAligned(alignUp(count * sizeof(T), CACHE_LINE_SIZE), CACHE_LINE_SIZE, tag);
+        }
+
+        // Markers turn the block into a stack. Freed memory is cleared so later allocations
+        // are still zeroed.
+        usize getMarker() const;
+        void  freeToMarker(usize marker);
+
+        void setBuffer(ptr _buffer);
+
+        const ptr getBuffer() const;
+        usize     getSize() const;
+        usize     getPeak() const;
+
+      private:
+        Allocator* allocator { nullptr };
+
+        ptr   buffer { nullptr };
+        usize size {};
+        uptr  index {};
+        usize peak {};
+
+#if defined(FR_DEBUG) || defined(FR_MEMORY_PROFILE)
+        // Runs of allocations sharing a tag, so freeToMarker() can credit the right tags.
+        struct TagRun {
+            usize    offset;
+            AllocTag tag;
+        };
+        static constexpr u32 TAG_RUN_COUNT { 64 };
+
+        TagRun tagRuns[TAG_RUN_COUNT] {};
+        u32    tagRunCount {};
+#endif
+    };
+
+    // Frees everything allocated from the static block during its lifetime.
+    class StaticScope {
+      public:
+        explicit StaticScope(StaticBlock* _block);
+        ~StaticScope();
+
+        StaticScope(const StaticScope &)            = delete;
+        StaticScope &operator=(const StaticScope &) = delete;
+
+      private:
+        StaticBlock* block { nullptr };
+        usize        marker {};
+    };
+
+    // Double buffered linear memory for data that only lives for a frame. Allocations stay valid
+    // until the end of the next frame, after which their half is reused.
+    class FrameBlock {
+      public:
+        FrameBlock(Allocator* _allocator);
+        ~FrameBlock();
+
         void        init(ptr _buffer, usize _size);
         Pointer<u8> alloc(usize _size);
+        Pointer<u8> allocAligned(usize _size, usize alignment);
+        void        swap();
+
+        template <typename T>
+        Pointer<T> alloc(usize count, usize alignment = alignof(T)) {
+            return allocAligned(count * sizeof(T), alignment > 16 ? alignment : 16);
+        }
+        template <typename T>
+        Pointer<T> allocIsolated(usize count) {
+            return allocAligned(alignUp(count * sizeof(T), CACHE_LINE_SIZE), CACHE_LINE_SIZE);
+        }
 
         void setBuffer(ptr _buffer);
 
         const ptr getBuffer() const;
         usize     getSize() const;
+        usize     getPeak() const;
 
       private:
         Allocator* allocator { nullptr };
 
         ptr   buffer { nullptr };
         usize size {};
+        uptr  start {};
         uptr  index {};
+        usize peak {};
+    };
+
+    // Page size backing the arena. Huge pages cut TLB misses on large arenas and fall back to
+    // the next option when the system cannot provide them.
+    enum AllocatorPages : u8 {
+        PAGES_DEFAULT          = 0, ///< Normal pages
+        PAGES_TRANSPARENT_HUGE = 1, ///< Normal pages that the kernel may merge into huge pages
+        PAGES_HUGE             = 2, ///< Explicit 2 MiB huge pages (MAP_HUGETLB)
     };
 
     class FROGENGINE_EXPORT Allocator {
@@ -51,25 +507,67 @@ namespace FrogEngine {
         Allocator();
         ~Allocator();
 
-        void init(const char* name);
+        void init(const char* name, AllocatorPages _pages = PAGES_DEFAULT);
         void resize(usize _size);
         void abort();
 
-        u32          getID();
-        ptr*         getBuffer();
-        usize        getSize();
-        StaticBlock* getStaticBlock();
+        // Aborts unless `alignment` is a power of two no larger than a page.
+        void checkAlignment(usize alignment);
+
+        u32              getID();
+        AllocatorPages   getPages();
+        ptr*             getBuffer();
+        usize            getSize();
+        StaticBlock*     getStaticBlock();
+        FrameBlock*      getFrameBlock();
+        DynamicBlock*    getDynamicBlock();
+        PoolBlock*       getPoolBlock();
+        MemoryProfile*   getProfile();
+        RelocationTable* getRelocationTable();
+
+        // Handles to memory that never moves, like static or dynamic allocations. Movable memory
+        // already owns an entry, see DynamicBlock::getHandle(), and must not be released here.
+        template <typename T>
+        Handle<T> createHandle(Pointer<T> pointer) {
+            return relocationTable.getHandle<T>(relocationTable.acquire((uptr)pointer.get()));
+        }
+        template <typename T>
+        void releaseHandle(Handle<T> handle) {
+            if (!relocationTable.isValid(handle))
+                FR_LOG_ERROR(ALLOCATOR, "Tried to release a stale handle");
+            relocationTable.release(handle.getIndex());
+        }
+        template <typename T>
+        T* resolve(Handle<T> handle) const {
+            return relocationTable.resolve(handle);
+        }
+
+        // Writes a heap map of the dynamic region for offline tools, see MemoryProfile.cpp for
+        // the format.
+        bool dumpHeap(const char* path);
 
       private:
+        void commit(usize _size);
+        void setPages(AllocatorPages _pages);
+
         u32 id {};
 
-        ptr   buffer { nullptr };
-        usize size {};
+        ptr            buffer { nullptr };
+        usize          size {};
+        usize          committed {};
+        const usize    reserveSize { 68'719'476'736 };
+        AllocatorPages pages { PAGES_DEFAULT };
 
-        const usize  staticSize { 2'144 };
+        usize        staticSize { 2'144 };
         StaticBlock  staticBlock;
+        usize        frameSize { 4'096 };
+        FrameBlock   frameBlock;
         usize        dynamicSize {};
         DynamicBlock dynamicBlock;
+        PoolBlock    poolBlock;
+
+        MemoryProfile   profile;
+        RelocationTable relocationTable;
     };
 }
 
@@ -0,0 +1,60 @@
+/**
+ * @file Atomic.h
+ * @brief Atomic Module
+ *
+ * This module provides the small set of synchronization primitives used inside FrogEngine. They
+ * are built directly on compiler intrinsics so they need neither the C++ standard library nor
+ * exceptions.
+ */
+#ifndef FROGENGINE_ATOMIC_H
+#define FROGENGINE_ATOMIC_H
+
+#include <FrogEngine/Utility.h>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#    include <immintrin.h>
+#    define FR_CPU_PAUSE() _mm_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+#    define FR_CPU_PAUSE() __asm__ __volatile__("yield")
+#else
+#    define FR_CPU_PAUSE()
+#endif
+
+namespace FrogEngine {
+    /**
+     * @class SpinLock
+     * @brief Test and test-and-set lock for short critical sections.
+     *
+     * @note Not recursive. Only use it around work that cannot block.
+     */
+    class SpinLock {
+      public:
+        void lock() {
+            while (__atomic_exchange_n(&locked, 1u, __ATOMIC_ACQUIRE))
+                while (__atomic_load_n(&locked, __ATOMIC_RELAXED)) FR_CPU_PAUSE();
+        }
+        bool tryLock() { return !__atomic_exchange_n(&locked, 1u, __ATOMIC_ACQUIRE); }
+        void unlock() { __atomic_store_n(&locked, 0u, __ATOMIC_RELEASE); }
+
+      private:
+        u32 locked { 0 };
+    };
+
+    /**
+     * @class SpinGuard
+     * @brief Holds a SpinLock for the lifetime of the guard.
+     */
+    class SpinGuard {
+      public:
+        explicit SpinGuard(SpinLock* _lock) : lock(_lock) { lock->lock(); }
+        ~SpinGuard() { lock->unlock(); }
+
+        SpinGuard(const SpinGuard &)            = delete;
+        SpinGuard &operator=(const SpinGuard &) = delete;
+
+      private:
+        SpinLock* lock;
+    };
+}
+
+#endif
@@ -0,0 +1,85 @@
+/**
+ * @file Clock.h
+ * @brief Clock Module
+ *
+ * Frame pacing on top of getTime(). FrameLimiter holds a target frame rate by sleeping until
+ * shortly before each deadline and spinning through the rest, with the spin window adapted to
+ * how late the OS actually wakes the thread. FixedStep turns variable frame times into a fixed
+ * number of simulation steps plus an interpolation factor for rendering.
+ */
+#ifndef FROGENGINE_CLOCK_H
+#define FROGENGINE_CLOCK_H
+
+#include <FrogEngine/Runtime.h>
+#include <FrogEngine/Utility.h>
+
+namespace FrogEngine {
+    constexpr u64 NANOSECONDS_PER_SECOND { 1'000'000'000 };
+    constexpr u64 NANOSECONDS_PER_MILLISECOND { 1'000'000 };
+    constexpr u64 NANOSECONDS_PER_MICROSECOND { 1'000 };
+
+    // Sleeps until getTime() reaches `time`, give or take the scheduler's wake up latency.
+    FROGENGINE_EXPORT void sleepUntil(u64 time);
+    FROGENGINE_EXPORT void sleepFor(u64 duration);
+
+    /**
+     * @class FrameLimiter
+     * @brief Waits out the rest of every frame to hold a target rate.
+     *
+     * Deadlines advance by exactly one period, so a late frame is made up by the next one
+     * instead of pushing every later frame back. Falling more than a whole period behind starts
+     * over from the current time.
+     */
+    class FROGENGINE_EXPORT FrameLimiter {
+      public:
+        // 0 does not limit the rate, but wait() still measures frame times.
+        FrameLimiter(u32 rate = 0);
+        ~FrameLimiter() = default;
+
+        void setRate(u32 rate);
+
+        // Waits until the next frame is due and returns nanoseconds since the last call, or 0
+        // on the first call.
+        u64 wait();
+
+        u64 getPeriod() const;
+        // Nanoseconds a sleep is expected to overshoot, which wait() spins through instead.
+        u64 getSpinWindow() const;
+
+      private:
+        u64 period {};
+        u64 deadline {};
+        u64 last {};
+        u64 sleepError {};
+    };
+
+    /**
+     * @class FixedStep
+     * @brief Splits frame time into fixed simulation steps.
+     *
+     * @note After a long stall, like a breakpoint, the steps beyond `_maxSteps` are dropped
+     * rather than simulated all at once.
+     */
+    class FROGENGINE_EXPORT FixedStep {
+      public:
+        FixedStep(u64 _step = NANOSECONDS_PER_SECOND / 60, u32 _maxSteps = 8);
+        ~FixedStep() = default;
+
+        // Adds a frame's duration and returns how many steps to simulate before rendering.
+        u32 advance(u64 elapsed);
+
+        // How far rendering is between the last two simulated states, from 0 up to 1.
+        f64 getAlpha() const;
+        f64 getStepSeconds() const;
+        // Steps simulated since construction.
+        u64 getStepCount() const;
+
+      private:
+        u64 step {};
+        u32 maxSteps {};
+        u64 accumulator {};
+        u64 stepCount {};
+    };
+}
+
+#endif
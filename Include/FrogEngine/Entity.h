@@ -0,0 +1,219 @@
+/**
+ * @file Entity.h
+ * @brief Entity Module
+ *
+ * Archetype based entity component system. Entities with the same set of components share an
+ * archetype, whose rows are kept dense in POOL_CHUNK_SIZE chunks from the pool. Inside a chunk
+ * every component is its own array, so queries stream through contiguous memory and skip
+ * archetypes that miss a component without looking at their entities.
+ */
+#ifndef FROGENGINE_ENTITY_H
+#define FROGENGINE_ENTITY_H
+
+#include <FrogEngine/Allocator.h>
+#include <FrogEngine/HashMap.h>
+#include <FrogEngine/Log.h>
+#include <FrogEngine/Pointer.h>
+#include <FrogEngine/Utility.h>
+
+#include <new>
+
+namespace FrogEngine {
+    constexpr u32 ENTITY_INDEX_BITS { 20 };
+    constexpr u32 ENTITY_INDEX_MASK { (1u << ENTITY_INDEX_BITS) - 1 };
+    constexpr u32 ENTITY_GENERATION_MASK { (1u << (32 - ENTITY_INDEX_BITS)) - 1 };
+    constexpr u32 ENTITY_NONE { ~0u };
+
+    constexpr u32 COMPONENT_MAX_COUNT { 64 };
+    constexpr u32 COMPONENT_NONE { ~0u };
+
+    // Bit i is set when the archetype has component i.
+    typedef u64 ComponentMask;
+
+    // A 20 bit index into the world's entity records and the low 12 bits of the record's
+    // generation, laid out like Handle. Destroyed entities go stale until the record has been
+    // reused 4096 times.
+    class Entity {
+      public:
+        Entity() = default;
+        explicit Entity(u32 index, u32 generation) :
+            value(index | (generation & ENTITY_GENERATION_MASK) << ENTITY_INDEX_BITS) {}
+        ~Entity() = default;
+
+        bool operator==(const Entity &other) const { return value == other.value; }
+        bool operator!=(const Entity &other) const { return value != other.value; }
+        operator bool() const { return value != ENTITY_NONE; }
+
+        u32 getIndex() const { return value & ENTITY_INDEX_MASK; }
+        u32 getGeneration() const { return value >> ENTITY_INDEX_BITS; }
+        u32 getValue() const { return value; }
+
+      private:
+        u32 value { ENTITY_NONE };
+    };
+
+    struct ComponentInfo {
+        u32 size {};
+        u32 alignment {};
+    };
+
+    // Component IDs are shared by every world. Register all components at startup, before any
+    // thread uses a world; registration is not thread safe.
+    FROGENGINE_EXPORT u32                  addComponentType(usize _size, usize alignment);
+    FROGENGINE_EXPORT const ComponentInfo* getComponentInfo(u32 component);
+
+    template <typename T>
+    struct ComponentType {
+        static u32 id;
+    };
+    template <typename T>
+    u32 ComponentType<T>::id { COMPONENT_NONE };
+
+    template <typename T>
+    u32 registerComponent() {
+        static_assert(IsRelocatable<T>::value, "Components are moved with memcpy");
+        if (ComponentType<T>::id == COMPONENT_NONE)
+            ComponentType<T>::id = addComponentType(sizeof(T), alignof(T));
+        return ComponentType<T>::id;
+    }
+    template <typename T>
+    u32 getComponentId() {
+#ifdef FR_DEBUG
+        if (ComponentType<T>::id == COMPONENT_NONE)
+            FR_LOG_ERROR(ENTITY, "Used a component of %zu bytes before registering it", sizeof(T));
+#endif
+        return ComponentType<T>::id;
+    }
+    template <typename... Ts>
+    ComponentMask getComponentMask() {
+        return (((ComponentMask)1 << getComponentId<Ts>()) | ... | 0);
+    }
+
+    /**
+     * @class World
+     * @brief Entities and their components.
+     *
+     * Adding or removing a component moves the entity into another archetype. Destroying an
+     * entity moves the last row of its archetype into the hole, so chunks stay dense. Pointers
+     * from get() are only valid until the next structural change.
+     *
+     * @note Not thread safe. Queries must not create, destroy, add or remove.
+     */
+    class FROGENGINE_EXPORT World {
+      public:
+        World(Allocator* _allocator);
+        ~World();
+
+        World(const World &)            = delete;
+        World &operator=(const World &) = delete;
+
+        Entity create();
+        void   destroy(Entity entity);
+        bool   isAlive(Entity entity) const;
+
+        template <typename... Ts>
+        Entity create(const Ts &...components) {
+            const Entity entity = createEntity(getComponentMask<Ts...>());
+            (new (getComponent(entity, getComponentId<Ts>())) Ts(components), ...);
+            return entity;
+        }
+        template <typename T>
+        T* add(Entity entity, const T &component = T()) {
+            const u32 id = getComponentId<T>();
+            setMask(entity, getMask(entity) | (ComponentMask)1 << id);
+            return new (getComponent(entity, id)) T(component);
+        }
+        template <typename T>
+        void remove(Entity entity) {
+            setMask(entity, getMask(entity) & ~((ComponentMask)1 << getComponentId<T>()));
+        }
+        template <typename T>
+        bool has(Entity entity) const {
+            return getMask(entity) & (ComponentMask)1 << getComponentId<T>();
+        }
+        // nullptr when the entity does not have the component.
+        template <typename T>
+        T* get(Entity entity) {
+            return (T*)getComponent(entity, getComponentId<T>());
+        }
+
+        // Calls visit(u32 count, const Entity* entities, Ts*... components) once per chunk of
+        // every archetype that has all of Ts. Arrays hold `count` elements.
+        template <typename... Ts, typename F>
+        void eachChunk(F visit) {
+            const ComponentMask mask = getComponentMask<Ts...>();
+            for (u32 i = 0; i < archetypeCount; i++) {
+                const Archetype &archetype = archetypes[i];
+                if ((archetype.mask & mask) != mask) continue;
+
+                const EntityChunk* chunks = archetype.chunks.get();
+                for (u32 j = 0; j < archetype.chunkCount; j++) {
+                    u8* const data = chunks[j].data.get();
+                    visit(
+                        chunks[j].count,
+                        (const Entity*)data,
+                        (Ts*)(data + archetype.columns[ComponentType<Ts>::id])...);
+                }
+            }
+        }
+        // Calls visit(Entity entity, Ts &...components) for every entity that has all of Ts.
+        template <typename... Ts, typename F>
+        void each(F visit) {
+            eachChunk<Ts...>([&visit](u32 count, const Entity* entities, Ts*... columns) {
+                for (u32 i = 0; i < count; i++) visit(entities[i], columns[i]...);
+            });
+        }
+
+        u32 getCount() const;
+        u32 getArchetypeCount() const;
+
+      private:
+        struct EntityChunk {
+            Pointer<u8> data;
+            u32         count {};
+        };
+        // Chunks start with the entity array, followed by one array per component at
+        // `columns[id]` bytes.
+        struct Archetype {
+            ComponentMask        mask {};
+            u32                  rowsPerChunk {};
+            u32                  chunkCount {};
+            u32                  chunkCapacity {};
+            Pointer<EntityChunk> chunks;
+            u16                  columns[COMPONENT_MAX_COUNT] {};
+        };
+        // Dead records link the free list through `chunk`.
+        struct EntityRecord {
+            u32 archetype {};
+            u32 chunk {};
+            u32 row {};
+            u32 generation {};
+        };
+
+        Entity        createEntity(ComponentMask mask);
+        ComponentMask getMask(Entity entity) const;
+        void          setMask(Entity entity, ComponentMask mask);
+        u8*           getComponent(Entity entity, u32 component);
+
+        EntityRecord* getRecord(Entity entity) const;
+        u32           findArchetype(ComponentMask mask);
+        void          pushRow(u32 archetype, Entity entity, EntityRecord* record);
+        void          removeRow(const EntityRecord* record);
+
+        DynamicBlock* block { nullptr };
+        PoolBlock*    pool { nullptr };
+
+        Pointer<Archetype>          archetypes;
+        u32                         archetypeCount {};
+        u32                         archetypeCapacity {};
+        HashMap<ComponentMask, u32> archetypeLookup;
+
+        Pointer<EntityRecord> records;
+        u32                   recordCount {};
+        u32                   recordCapacity {};
+        u32                   freeRecord { ENTITY_NONE };
+        u32                   aliveCount {};
+    };
+}
+
+#endif
@@ -0,0 +1,195 @@
+/**
+ * @file Format.h
+ * @brief Format Module
+ *
+ * Type checked front end of the engine's printf style formatter. A literal format converts to a
+ * FormatString, whose consteval constructor checks it against the types of the arguments: every
+ * conversion needs an argument of its kind, integers have to match the size the length modifier
+ * names, and the counts have to agree. A mismatch fails the build with the name of the problem
+ * instead of printing garbage or reading past the arguments.
+ *
+ * The formatting itself is a single pass straight into the caller's buffer, the stack or memory
+ * from a FrameBlock alike, see formatArguments() in Runtime.h.
+ */
+#ifndef FROGENGINE_FORMAT_H
+#define FROGENGINE_FORMAT_H
+
+#include <FrogEngine/Runtime.h>
+#include <FrogEngine/Utility.h>
+
+namespace FrogEngine {
+    // Kind of an argument type and its size once passed through `...`. Types that can not be
+    // formatted are not `valid`.
+    struct FormatType {
+        FormatArgument kind {};
+        u8             size {};
+        bool           valid {};
+    };
+
+    template <typename T>
+    consteval FormatType getFormatType() {
+        if constexpr (__is_enum(T)) {
+            return getFormatType<__underlying_type(T)>();
+        } else if constexpr (__is_same(T, float) || __is_same(T, double)) {
+            return { ARGUMENT_FLOAT, sizeof(f64), true };
+        } else if constexpr (
+            __is_same(T, bool) || __is_same(T, char) || __is_same(T, signed char)
+            || __is_same(T, unsigned char) || __is_same(T, short) || __is_same(T, unsigned short)
+            || __is_same(T, int) || __is_same(T, unsigned) || __is_same(T, long)
+            || __is_same(T, unsigned long) || __is_same(T, long long)
+            || __is_same(T, unsigned long long) || __is_same(T, wchar_t)
+            || __is_same(T, char8_t) || __is_same(T, char16_t) || __is_same(T, char32_t)) {
+            // Anything smaller is promoted to an int.
+            const u8 size = sizeof(T) < sizeof(int) ? sizeof(int) : sizeof(T);
+            return { T(-1) < T(0) ? ARGUMENT_INT : ARGUMENT_UNSIGNED, size, true };
+        } else if constexpr (__is_same(T, decltype(nullptr))) {
+            return { ARGUMENT_POINTER, sizeof(ptr), true };
+        } else {
+            return {};
+        }
+    }
+
+    template <typename T>
+    struct FormatTraits {
+        static constexpr FormatType TYPE { getFormatType<T>() };
+    };
+    // Pointers to characters are text, which %p prints as well.
+    template <typename T>
+    struct FormatTraits<T*> {
+        static constexpr FormatType TYPE {
+            __is_same(T, char) || __is_same(T, const char) ? ARGUMENT_TEXT : ARGUMENT_POINTER,
+            sizeof(ptr),
+            true,
+        };
+    };
+    template <typename T, usize N>
+    struct FormatTraits<T[N]> : FormatTraits<T*> {};
+
+    // Deliberately never defined or constexpr. A format check that calls one fails to compile
+    // and the error names the function.
+    void formatTooFewArguments();
+    void formatTooManyArguments();
+    void formatArgumentMismatch();
+    void formatUnknownConversion();
+
+    consteval void checkFormat(const char* format, const FormatType* types, u32 count) {
+        u32        next = 0;
+        const auto take = [&]() {
+            if (next == count) formatTooFewArguments();
+            return types[next++];
+        };
+        const auto isInteger = [](FormatType type) {
+            return type.valid && (type.kind == ARGUMENT_INT || type.kind == ARGUMENT_UNSIGNED);
+        };
+
+        while (*format) {
+            if (*format++ != '%') continue;
+
+            while (*format == '-' || *format == '0' || *format == '#' || *format == '+'
+                   || *format == ' ')
+                format++;
+            for (u32 field = 0; field < 2; field++) {
+                // Width, then precision after a '.'.
+                if (field && *format != '.') break;
+                if (field) format++;
+                if (*format == '*') {
+                    const FormatType star = take();
+                    if (!isInteger(star) || star.size != sizeof(int)) formatArgumentMismatch();
+                    format++;
+                }
+                while (*format >= '0' && *format <= '9') format++;
+            }
+
+            // Size an integer argument has to be.
+            u32 size = sizeof(int);
+            if (*format == 'h') {
+                format += format[1] == 'h' ? 2 : 1;
+            } else if (*format == 'l') {
+                size    = format[1] == 'l' ? sizeof(long long) : sizeof(long);
+                format += format[1] == 'l' ? 2 : 1;
+            } else if (*format == 'z' || *format == 'j' || *format == 't') {
+                size = *format == 'j' ? sizeof(i64) : sizeof(usize);
+                format++;
+            }
+
+            FormatType type {};
+            switch (*format++) {
+                case '%': break;
+                case 'd':
+                case 'i':
+                case 'u':
+                case 'x':
+                case 'X':
+                case 'o':
+                    type = take();
+                    if (!isInteger(type) || type.size != size) formatArgumentMismatch();
+                    break;
+                case 'c':
+                    type = take();
+                    if (!isInteger(type) || type.size != sizeof(int)) formatArgumentMismatch();
+                    break;
+                case 'f':
+                case 'F':
+                    type = take();
+                    if (!type.valid || type.kind != ARGUMENT_FLOAT) formatArgumentMismatch();
+                    break;
+                case 's':
+                    type = take();
+                    if (!type.valid || type.kind != ARGUMENT_TEXT) formatArgumentMismatch();
+                    break;
+                case 'p':
+                    type = take();
+                    if (!type.valid
+                        || (type.kind != ARGUMENT_POINTER && type.kind != ARGUMENT_TEXT))
+                        formatArgumentMismatch();
+                    break;
+                default: formatUnknownConversion();
+            }
+        }
+        if (next != count) formatTooManyArguments();
+    }
+
+    /**
+     * @class FormatString
+     * @brief A format checked against the types of its arguments while compiling.
+     *
+     * @note Only string literals and other constants convert to one. Formats only known at
+     * runtime go through formatArguments() unchecked.
+     */
+    template <typename... Arguments>
+    struct FormatString {
+        const char* text;
+
+        consteval FormatString(const char* _text) : text(_text) {
+            constexpr FormatType TYPES[] { FormatTraits<Arguments>::TYPE..., FormatType {} };
+            checkFormat(_text, TYPES, sizeof...(Arguments));
+        }
+    };
+
+    // Keeps the format out of template argument deduction, so the arguments alone decide.
+    template <typename T>
+    struct FormatIdentity {
+        typedef T Type;
+    };
+    template <typename... Arguments>
+    using CheckedFormat = FormatString<typename FormatIdentity<Arguments>::Type...>;
+
+    // How an argument goes through `...`: enums as their underlying type, arrays as pointers.
+    template <typename T>
+    constexpr auto passFormatArgument(const T& value) {
+        if constexpr (__is_enum(T)) return (__underlying_type(T))value;
+        else return value;
+    }
+
+    // formatArguments() with the format checked against the arguments.
+    template <typename... Arguments>
+    inline i32 formatString(
+        char*                       buffer,
+        usize                       _size,
+        CheckedFormat<Arguments...> format,
+        const Arguments&... arguments) {
+        return formatArguments(buffer, _size, format.text, passFormatArgument(arguments)...);
+    }
+}
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef FROGENGINE_HANDLE_H
+#define FROGENGINE_HANDLE_H
+
+#include <FrogEngine/Utility.h>
+
+namespace FrogEngine {
+    constexpr u32 HANDLE_INDEX_BITS { 20 };
+    constexpr u32 HANDLE_INDEX_MASK { (1u << HANDLE_INDEX_BITS) - 1 };
+    constexpr u32 HANDLE_GENERATION_MASK { (1u << (32 - HANDLE_INDEX_BITS)) - 1 };
+    constexpr u32 HANDLE_NONE { ~0u };
+
+    // Handles are a 20 bit relocation table index and the low 12 bits of the entry's
+    // generation, resolved through RelocationTable::resolve(). At 4 bytes they are a quarter of
+    // a release Pointer. A handle goes stale once its entry is released, which resolve() catches
+    // until the entry has been reused 4096 times.
+    template <typename T>
+    class Handle {
+      public:
+        Handle() = default;
+        explicit Handle(u32 index, u32 generation) :
+            value(index | (generation & HANDLE_GENERATION_MASK) << HANDLE_INDEX_BITS) {}
+        ~Handle() = default;
+
+        template <typename U>
+        Handle(const Handle<U> &other) : value(other.getValue()) {}
+
+        bool operator==(const Handle &other) const { return value == other.value; }
+        bool operator!=(const Handle &other) const { return value != other.value; }
+        operator bool() const { return value != HANDLE_NONE; }
+
+        u32 getIndex() const { return value & HANDLE_INDEX_MASK; }
+        u32 getGeneration() const { return value >> HANDLE_INDEX_BITS; }
+        u32 getValue() const { return value; }
+
+      private:
+        u32 value { HANDLE_NONE };
+    };
+}
+
+#endif
@@ -0,0 +1,77 @@
+/**
+ * @file Hash.h
+ * @brief Hash Module
+ *
+ * Hash functions shared by the whole engine. Everything is constexpr, so hashes of string
+ * literals can be computed at compile time and compared as integers at runtime.
+ */
+#ifndef FROGENGINE_HASH_H
+#define FROGENGINE_HASH_H
+
+#include <FrogEngine/Utility.h>
+
+namespace FrogEngine {
+    constexpr u32 DJB2_BASIS { 5'381 };
+    constexpr u64 FNV_BASIS { 0xCB'F2'9C'E4'84'22'23'25 };
+    constexpr u64 FNV_PRIME { 0x00'00'01'00'00'00'01'B3 };
+
+    // djb2 over a null terminated string. Only used for the app ID, which names the cache and
+    // save directories and therefore must never change.
+    constexpr u32 hashDjb2(const char* text, u32 hash = DJB2_BASIS) {
+        return *text ? hashDjb2(text + 1, (hash << 5) + hash + (u8)*text) : hash;
+    }
+
+    // 64 bit FNV-1a, the hash behind StringId.
+    constexpr u64 hashString(const char* text, usize length) {
+        u64 hash = FNV_BASIS;
+        for (usize i = 0; i < length; i++) hash = (hash ^ (u8)text[i]) * FNV_PRIME;
+        return hash;
+    }
+    constexpr u64 hashString(const char* text) {
+        u64 hash = FNV_BASIS;
+        while (*text) hash = (hash ^ (u8)*text++) * FNV_PRIME;
+        return hash;
+    }
+
+    // Finalizer of MurmurHash3. Spreads every input bit over the whole result, which HashMap
+    // needs because it takes the slot from the high bits and the control byte from the low ones.
+    constexpr u64 mixHash(u64 value) {
+        value ^= value >> 33;
+        value *= 0xFF'51'AF'D7'ED'55'8C'CD;
+        value ^= value >> 33;
+        value *= 0xC4'CE'B9'FE'1A'85'EC'53;
+        value ^= value >> 33;
+        return value;
+    }
+
+    // Hash functor used by HashMap. Specialize it for other key types.
+    template <typename K>
+    struct Hash;
+
+    template <typename K>
+    struct HashInteger {
+        u64 operator()(K key) const { return mixHash((u64)key); }
+    };
+    template <>
+    struct Hash<i8> : HashInteger<i8> {};
+    template <>
+    struct Hash<i16> : HashInteger<i16> {};
+    template <>
+    struct Hash<i32> : HashInteger<i32> {};
+    template <>
+    struct Hash<i64> : HashInteger<i64> {};
+    template <>
+    struct Hash<u8> : HashInteger<u8> {};
+    template <>
+    struct Hash<u16> : HashInteger<u16> {};
+    template <>
+    struct Hash<u32> : HashInteger<u32> {};
+    template <>
+    struct Hash<u64> : HashInteger<u64> {};
+    template <typename T>
+    struct Hash<T*> {
+        u64 operator()(const T* key) const { return mixHash((uptr)key); }
+    };
+}
+
+#endif
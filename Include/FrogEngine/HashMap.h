@@ -0,0 +1,268 @@
+/**
+ * @file HashMap.h
+ * @brief Hash Map Module
+ *
+ * Open addressing hash map in the style of Swiss tables. Every slot has a control byte holding 7
+ * bits of its hash, and lookups compare 16 control bytes at once with SSE2 before touching any
+ * key. Platforms without SSE2 compare them one at a time.
+ *
+ * Storage comes from dynamic memory, and nothing throws. Running out of memory goes through the
+ * allocator's error path like every other dynamic allocation.
+ */
+#ifndef FROGENGINE_HASH_MAP_H
+#define FROGENGINE_HASH_MAP_H
+
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#    include <emmintrin.h>
+#    define FR_HASH_SSE2
+#endif
+
+#include <FrogEngine/Allocator.h>
+#include <FrogEngine/Hash.h>
+#include <FrogEngine/Pointer.h>
+#include <FrogEngine/Utility.h>
+
+namespace FrogEngine {
+    constexpr u32   HASH_GROUP_SIZE { 16 };
+    constexpr usize HASH_MIN_CAPACITY { HASH_GROUP_SIZE };
+
+    // Control bytes of full slots are the low 7 bits of their hash, so both markers have the top
+    // bit set.
+    constexpr u8 HASH_EMPTY { 0x80 };
+    constexpr u8 HASH_DELETED { 0xFE };
+
+    // 16 control bytes. Every match returns a bit mask with bit i set when byte i matches.
+    struct HashGroup {
+#ifdef FR_HASH_SSE2
+        explicit HashGroup(const u8* _controls) :
+            controls(_mm_load_si128((const __m128i*)_controls)) {}
+
+        u32 match(u8 control) const {
+            return (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(controls, _mm_set1_epi8((char)control)));
+        }
+        u32 matchEmpty() const { return match(HASH_EMPTY); }
+        // Both markers have the top bit set and full slots do not.
+        u32 matchFree() const { return (u32)_mm_movemask_epi8(controls); }
+
+        __m128i controls;
+#else
+        explicit HashGroup(const u8* _controls) : controls(_controls) {}
+
+        u32 match(u8 control) const {
+            u32 mask = 0;
+            for (u32 i = 0; i < HASH_GROUP_SIZE; i++) mask |= (u32)(controls[i] == control) << i;
+            return mask;
+        }
+        u32 matchEmpty() const { return match(HASH_EMPTY); }
+        u32 matchFree() const {
+            u32 mask = 0;
+            for (u32 i = 0; i < HASH_GROUP_SIZE; i++) mask |= (u32)(controls[i] >> 7) << i;
+            return mask;
+        }
+
+        const u8* controls;
+#endif
+    };
+
+    /**
+     * @class HashMap
+     * @brief Open addressing map from K to V in dynamic memory.
+     *
+     * Keys and values are moved with memcpy when the table grows, so both have to be
+     * relocatable. Pointers returned by insert() and find() stay valid until the next insert()
+     * that grows the table, reserve() or rehash().
+     *
+     * @note Not thread safe.
+     */
+    template <typename K, typename V, typename H = Hash<K>>
+    class HashMap {
+        static_assert(IsRelocatable<K>::value, "Keys have to be relocatable");
+        static_assert(IsRelocatable<V>::value, "Values have to be relocatable");
+
+      public:
+        explicit HashMap(DynamicBlock* _block, AllocTag _tag = TAG_GENERAL) :
+            block(_block), tag(_tag) {}
+        ~HashMap() { release(); }
+
+        HashMap(const HashMap &)            = delete;
+        HashMap &operator=(const HashMap &) = delete;
+
+        // Inserts `key` or overwrites its value. Returns the stored value.
+        V* insert(const K &key, const V &value) {
+            const u64 hash  = H()(key);
+            usize     index = findIndex(key, hash);
+            if (index == HASH_NOT_FOUND) {
+                index = findFree(hash);
+                if (!growthLeft && getControls()[index] == HASH_EMPTY) {
+                    // Tombstones alone are cleaned up without growing.
+                    rehash(count * 2 < capacity ? capacity : capacity * 2);
+                    index = findFree(hash);
+                }
+                if (getControls()[index] == HASH_EMPTY) growthLeft--;
+                setControl(index, (u8)(hash & 0x7F));
+                new (&getSlots()[index].key) K(key);
+                count++;
+            } else {
+                getSlots()[index].value.~V();
+            }
+            Slot* slot = &getSlots()[index];
+            new (&slot->value) V(value);
+            return &slot->value;
+        }
+        V* find(const K &key) const {
+            const usize index = findIndex(key, H()(key));
+            return index == HASH_NOT_FOUND ? nullptr : &getSlots()[index].value;
+        }
+        bool contains(const K &key) const { return findIndex(key, H()(key)) != HASH_NOT_FOUND; }
+        bool erase(const K &key) {
+            const usize index = findIndex(key, H()(key));
+            if (index == HASH_NOT_FOUND) return false;
+
+            Slot* slot = &getSlots()[index];
+            slot->key.~K();
+            slot->value.~V();
+            count--;
+
+            // Probes stop at the first group with an empty slot, so a slot in such a group can
+            // go back to empty. Otherwise it has to stay a tombstone.
+            const usize group = index & ~(usize)(HASH_GROUP_SIZE - 1);
+            if (HashGroup(getControls() + group).matchEmpty()) {
+                setControl(index, HASH_EMPTY);
+                growthLeft++;
+            } else {
+                setControl(index, HASH_DELETED);
+            }
+            return true;
+        }
+        void clear() {
+            if (!capacity) return;
+            forEach([](const K &key, V &value) {
+                key.~K();
+                value.~V();
+            });
+            memset(getControls(), HASH_EMPTY, capacity);
+            count      = 0;
+            growthLeft = getGrowthLimit(capacity);
+        }
+
+        // Makes room for `_count` entries without growing again.
+        void reserve(usize _count) {
+            if (_count <= getGrowthLimit(capacity)) return;
+            usize target = HASH_MIN_CAPACITY;
+            while (getGrowthLimit(target) < _count) target *= 2;
+            rehash(target);
+        }
+        // Moves every entry into a table of `_capacity` slots, rounded up to a power of two and
+        // never below what the current entries need.
+        void rehash(usize _capacity) {
+            usize target = HASH_MIN_CAPACITY;
+            while (target < _capacity || getGrowthLimit(target) < count) target *= 2;
+
+            const usize   old_capacity = capacity;
+            Pointer<u8>   old_controls = controls;
+            Pointer<Slot> old_slots    = slots;
+
+            controls   = block->alloc<u8>(target, HASH_GROUP_SIZE, tag);
+            slots      = block->alloc<Slot>(target, alignof(Slot), tag);
+            capacity   = target;
+            growthLeft = getGrowthLimit(target) - count;
+            memset(getControls(), HASH_EMPTY, target);
+
+            const u8* const   old_control_bytes = old_capacity ? old_controls.get() : nullptr;
+            const Slot* const old_slot_array    = old_capacity ? old_slots.get() : nullptr;
+            for (usize i = 0; i < old_capacity; i++) {
+                if (old_control_bytes[i] & 0x80) continue;
+                const u64   hash  = H()(old_slot_array[i].key);
+                const usize index = findFree(hash);
+                setControl(index, (u8)(hash & 0x7F));
+                memcpy((ptr)&getSlots()[index], &old_slot_array[i], sizeof(Slot));
+            }
+
+            if (old_capacity) {
+                block->dealloc(old_controls, old_capacity);
+                block->dealloc(old_slots, old_capacity);
+            }
+        }
+
+        // Calls visit(const K &, V &) for every entry in slot order.
+        template <typename F>
+        void forEach(F visit) {
+            u8* const   _controls = getControls();
+            Slot* const _slots    = getSlots();
+            for (usize i = 0; i < capacity; i++)
+                if (!(_controls[i] & 0x80)) visit(_slots[i].key, _slots[i].value);
+        }
+
+        usize getCount() const { return count; }
+        usize getCapacity() const { return capacity; }
+
+      private:
+        struct Slot {
+            K key;
+            V value;
+        };
+
+        static constexpr usize HASH_NOT_FOUND { ~(usize)0 };
+
+        // Keeps at least one slot in eight empty, so probes stay short and always end.
+        static usize getGrowthLimit(usize _capacity) { return _capacity - _capacity / 8; }
+
+        u8*   getControls() const { return capacity ? controls.get() : nullptr; }
+        Slot* getSlots() const { return capacity ? slots.get() : nullptr; }
+        void  setControl(usize index, u8 control) { getControls()[index] = control; }
+
+        // Groups are visited with triangular steps, which reach every group of a power of two
+        // table once.
+        usize findIndex(const K &key, u64 hash) const {
+            if (!capacity) return HASH_NOT_FOUND;
+
+            const u8* const   _controls = getControls();
+            const Slot* const _slots    = getSlots();
+            const usize       mask      = capacity / HASH_GROUP_SIZE - 1;
+            usize             group     = (hash >> 7) & mask;
+            for (usize step = 1;; step++) {
+                const HashGroup probe(_controls + group * HASH_GROUP_SIZE);
+                for (u32 match = probe.match((u8)(hash & 0x7F)); match; match &= match - 1) {
+                    const usize index = group * HASH_GROUP_SIZE + __builtin_ctz(match);
+                    if (_slots[index].key == key) return index;
+                }
+                if (probe.matchEmpty() || step > mask) return HASH_NOT_FOUND;
+                group = (group + step) & mask;
+            }
+        }
+        // First empty or deleted slot on the probe sequence of `hash`. Grows empty tables.
+        usize findFree(u64 hash) {
+            if (!capacity) rehash(HASH_MIN_CAPACITY);
+
+            const u8* const _controls = getControls();
+            const usize     mask      = capacity / HASH_GROUP_SIZE - 1;
+            usize           group     = (hash >> 7) & mask;
+            for (usize step = 1;; step++) {
+                const u32 free = HashGroup(_controls + group * HASH_GROUP_SIZE).matchFree();
+                if (free) return group * HASH_GROUP_SIZE + __builtin_ctz(free);
+                group = (group + step) & mask;
+            }
+        }
+
+        void release() {
+            if (!capacity) return;
+            clear();
+            block->dealloc(controls, capacity);
+            block->dealloc(slots, capacity);
+            capacity = 0;
+        }
+
+        DynamicBlock* block { nullptr };
+        AllocTag      tag { TAG_GENERAL };
+
+        Pointer<u8>   controls;
+        Pointer<Slot> slots;
+        usize         capacity {};
+        usize         count {};
+        usize         growthLeft {};
+    };
+}
+
+#endif
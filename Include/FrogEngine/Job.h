@@ -0,0 +1,164 @@
+/**
+ * @file Job.h
+ * @brief Job Module
+ *
+ * Work stealing job system. Every worker owns a Chase-Lev deque: it pushes and pops jobs at the
+ * bottom without contention, while idle workers steal the oldest jobs from the top. Jobs live in
+ * a fixed pool of cache line sized slots in dynamic memory with a lock-free free list, so
+ * submitting never touches the allocator's locks.
+ */
+#ifndef FROGENGINE_JOB_H
+#define FROGENGINE_JOB_H
+
+#include <FrogEngine/Allocator.h>
+#include <FrogEngine/Pointer.h>
+#include <FrogEngine/Thread.h>
+#include <FrogEngine/Utility.h>
+
+#include <new>
+
+namespace FrogEngine {
+    constexpr u32   JOB_POOL_SIZE { 4'096 };
+    constexpr u32   JOB_DEQUE_SIZE { 1'024 };
+    constexpr u32   JOB_MAX_WORKERS { 64 };
+    constexpr usize JOB_PAYLOAD_SIZE { 48 };
+    constexpr u32   JOB_NONE { ~0u };
+
+    typedef void (*JobFunction)(ptr payload);
+
+    // Number of unfinished jobs. Pass one to run() and wait on it with JobSystem::wait().
+    struct JobCounter {
+        u32 value {};
+
+        bool isDone() const { return !__atomic_load_n(&value, __ATOMIC_ACQUIRE); }
+    };
+
+    // The closure is constructed in place in `payload`. Free slots link through `next`.
+    struct alignas(CACHE_LINE_SIZE) Job {
+        JobFunction function;
+        JobCounter* counter;
+        union {
+            u32 next;
+            u8  payload[JOB_PAYLOAD_SIZE];
+        };
+    };
+
+    /**
+     * @class JobSystem
+     * @brief Runs jobs on one worker per core.
+     *
+     * The thread that calls init() becomes worker 0 and runs jobs while it waits. Jobs should
+     * only be submitted from workers; other threads run them inline. When the pool or a deque is
+     * full, the job runs inline as well. Closures are limited to JOB_PAYLOAD_SIZE bytes, so
+     * capture large state by pointer.
+     *
+     * @note One job system per process, since workers know their index through a thread local.
+     */
+    class FROGENGINE_EXPORT JobSystem {
+      public:
+        JobSystem(Allocator* _allocator);
+        ~JobSystem();
+
+        JobSystem(const JobSystem &)            = delete;
+        JobSystem &operator=(const JobSystem &) = delete;
+
+        // `_workerCount` includes the calling thread. 0 uses one worker per core.
+        void init(u32 _workerCount = 0);
+
+        template <typename F>
+        void run(F function, JobCounter* counter = nullptr) {
+            static_assert(sizeof(F) <= JOB_PAYLOAD_SIZE, "Capture large state by pointer");
+            static_assert(alignof(F) <= alignof(u64), "Closure is over aligned");
+
+            const u32 index = allocJob();
+            if (index == JOB_NONE) {
+                function();
+                return;
+            }
+            Job* job      = &jobs[index];
+            job->function = [](ptr payload) {
+                F* closure = (F*)payload;
+                (*closure)();
+                closure->~F();
+            };
+            job->counter = counter;
+            new (job->payload) F(function);
+            submit(index);
+        }
+
+        // Runs other jobs until the counter reaches zero.
+        void wait(JobCounter* counter);
+
+        // Calls function(u32 begin, u32 end) over [0, count) and returns once every range is
+        // done. Ranges are split in halves until they are at most `batch` long, so idle workers
+        // steal large halves first. 0 picks a batch giving every worker about eight ranges.
+        template <typename F>
+        void parallelFor(u32 count, F function, u32 batch = 0) {
+            JobCounter counter;
+            splitRange(
+                [](ptr closure, u32 begin, u32 end) { (*(F*)closure)(begin, end); },
+                &function,
+                0,
+                count,
+                batch ? batch : getBatchSize(count),
+                &counter);
+            wait(&counter);
+        }
+
+        u32 getWorkerCount() const;
+        // Index of the calling worker, or JOB_NONE for threads outside the job system.
+        u32 getWorkerIndex() const;
+
+      private:
+        typedef void (*RangeFunction)(ptr closure, u32 begin, u32 end);
+
+        struct alignas(CACHE_LINE_SIZE) Worker {
+            // Owner and thieves race on `top`, only the owner writes `bottom`.
+            alignas(CACHE_LINE_SIZE) i64 top {};
+            alignas(CACHE_LINE_SIZE) i64 bottom {};
+            JobSystem* system { nullptr };
+            u32        index {};
+            u32        random {};
+            Thread     thread;
+            u32        deque[JOB_DEQUE_SIZE];
+        };
+
+        u32  allocJob();
+        void freeJob(u32 index);
+        void submit(u32 index);
+        void execute(u32 index);
+
+        bool push(Worker* worker, u32 index);
+        u32  pop(Worker* worker);
+        u32  steal(Worker* worker);
+        u32  find(u32 thief);
+        bool runOnce();
+
+        void splitRange(
+            RangeFunction function,
+            ptr           closure,
+            u32           begin,
+            u32           end,
+            u32           batch,
+            JobCounter*   counter);
+        u32 getBatchSize(u32 count) const;
+
+        static void work(ptr argument);
+        void        sleep();
+
+        Allocator*    allocator { nullptr };
+        DynamicBlock* block { nullptr };
+
+        Pointer<Job>    jobs;
+        Pointer<Worker> workers;
+        u32             workerCount {};
+
+        // Free list head: pool index in the low half and a tag in the high half against ABA.
+        alignas(CACHE_LINE_SIZE) u64 freeJobs {};
+        alignas(CACHE_LINE_SIZE) u32 epoch {};
+        u32  sleepers {};
+        bool running {};
+    };
+}
+
+#endif
@@ -7,7 +7,22 @@
  * error.
  *
  * The logging functions follow a `printf`-style formatting convention, allowing flexible message
- * composition with variable arguments.
+ * composition with variable arguments. Formats are checked against the arguments while compiling,
+ * see Format.h.
+ *
+ * Informational and warning messages are formatted off the calling thread. The caller copies the
+ * format pointer and its arguments into a ring of its own, and a background thread formats and
+ * writes what the rings hold in batches. When a ring is full the message is dropped and the drop
+ * is reported later. Format strings are read after the call returns, so they have to be string
+ * literals or otherwise outlive the program's logging.
+ *
+ * Engine code logs through the FR_LOG_TRACE(), FR_LOG_INFO(), FR_LOG_WARNING() and FR_LOG_ERROR()
+ * macros, which name the channel a message belongs to. Levels below FR_LOG_MIN_LEVEL are compiled
+ * out along with their arguments, and each channel has a runtime mask of the levels it writes.
+ *
+ * For long runs, openLogFile() sends every message to a binary file instead, which stores each
+ * format string once and the arguments packed, see LogFile.h. The frlog-decode tool turns it
+ * back into text.
  *
  * These functions are disregarded in release mode.
  */
@@ -15,9 +30,10 @@
 #define FROGENGINE_LOG_H
 
 #include <stdarg.h>
-#include <stdio.h>
 #include <stdlib.h>
 
+#include <FrogEngine/Format.h>
+#include <FrogEngine/Runtime.h>
 #include <FrogEngine/Utility.h>
 
 #define FR_LOG_FORMAT_RESET         "\033[0m"
@@ -64,7 +80,135 @@
 #define FR_LOG_FORMAT_BG_BRIGHT_CYAN    "\033[106m"
 #define FR_LOG_FORMAT_BG_BRIGHT_WHITE   "\033[107m"
 
+// Levels as numbers, so builds can pick the least severe level compiled in with
+// -DFR_LOG_MIN_LEVEL=FR_LOG_LEVEL_TRACE. Debug builds default to every level, FR_LOG builds to
+// INFO and up, and release builds to none, where FR_LOG_ERROR() still exits.
+#define FR_LOG_LEVEL_TRACE   0
+#define FR_LOG_LEVEL_INFO    1
+#define FR_LOG_LEVEL_WARNING 2
+#define FR_LOG_LEVEL_ERROR   3
+#define FR_LOG_LEVEL_NONE    4
+
+#ifndef FR_LOG_MIN_LEVEL
+#    if defined(FR_DEBUG)
+#        define FR_LOG_MIN_LEVEL FR_LOG_LEVEL_TRACE
+#    elif defined(FR_LOG)
+#        define FR_LOG_MIN_LEVEL FR_LOG_LEVEL_INFO
+#    else
+#        define FR_LOG_MIN_LEVEL FR_LOG_LEVEL_NONE
+#    endif
+#endif
+
+// Logs to a channel named without its prefix, like FR_LOG_INFO(ALLOCATOR, "%zu bytes", size).
+// Below FR_LOG_MIN_LEVEL the call and its arguments are compiled out; above it, the channel's
+// runtime mask costs one branch before any argument is evaluated.
+#define FR_LOG_AT(level, channel, ...)                                                         \
+    do {                                                                                       \
+        if constexpr (level >= FR_LOG_MIN_LEVEL)                                               \
+            if (::FrogEngine::isLogEnabled(::FrogEngine::CHANNEL_##channel, level))            \
+                ::FrogEngine::logMessage(level, ::FrogEngine::CHANNEL_##channel, __VA_ARGS__); \
+    } while (0)
+#define FR_LOG_TRACE(channel, ...)   FR_LOG_AT(::FrogEngine::LOG_TRACE, channel, __VA_ARGS__)
+#define FR_LOG_INFO(channel, ...)    FR_LOG_AT(::FrogEngine::LOG_INFO, channel, __VA_ARGS__)
+#define FR_LOG_WARNING(channel, ...) FR_LOG_AT(::FrogEngine::LOG_WARNING, channel, __VA_ARGS__)
+// Exits whether or not the message is compiled in.
+#define FR_LOG_ERROR(channel, ...) \
+    ::FrogEngine::logError(::FrogEngine::CHANNEL_##channel, __VA_ARGS__)
+
 namespace FrogEngine {
+    constexpr usize LOG_LINE_SIZE { 1'024 };
+    constexpr usize LOG_SUFFIX_SIZE { 32 };
+
+    enum LogLevel : u8 {
+        LOG_TRACE   = FR_LOG_LEVEL_TRACE,   ///< Verbose tracing, off until a channel enables it
+        LOG_INFO    = FR_LOG_LEVEL_INFO,    ///< Written to the standard output
+        LOG_WARNING = FR_LOG_LEVEL_WARNING, ///< Written to the standard error
+        LOG_ERROR   = FR_LOG_LEVEL_ERROR,   ///< Written synchronously before exiting
+    };
+
+    // Subsystem a message comes from, printed in its own color before the message. Applications
+    // can add their own channels from CHANNEL_USER up to LOG_CHANNEL_COUNT.
+    enum LogChannel : u8 {
+        CHANNEL_GENERAL   = 0, ///< No prefix
+        CHANNEL_ALLOCATOR = 1, ///< Allocator module
+        CHANNEL_SAVE      = 2, ///< Save module
+        CHANNEL_WINDOW    = 3, ///< Window module
+        CHANNEL_STRING    = 4, ///< Interned strings
+        CHANNEL_ENTITY    = 5, ///< Entity module
+        CHANNEL_JOB       = 6, ///< Job system
+        CHANNEL_TASK      = 7, ///< Task graph
+        CHANNEL_LOG       = 8, ///< The logger itself
+        CHANNEL_USER      = 9, ///< First application channel
+    };
+    constexpr u32 LOG_CHANNEL_COUNT { 16 };
+
+    // Levels each channel writes, bit `level` for each LogLevel. Every channel starts with INFO
+    // and up.
+    extern FROGENGINE_EXPORT u8 logChannelMasks[LOG_CHANNEL_COUNT];
+
+    inline bool isLogEnabled(LogChannel channel, LogLevel level) {
+        return __atomic_load_n(&logChannelMasks[channel], __ATOMIC_RELAXED) >> level & 1;
+    }
+    // Writes `minimum` and every more severe level of the channel, or nothing past LOG_ERROR.
+    FROGENGINE_EXPORT void setLogLevel(LogChannel channel, LogLevel minimum);
+    FROGENGINE_EXPORT const char* getChannelName(LogChannel channel);
+
+    /**
+     * @brief Formats a log line.
+     *
+     * The message is truncated so `suffix` always fits, and the whole line goes out in a single
+     * write.
+     *
+     * @return Length of the line without the terminator.
+     */
+    inline usize formatLogLine(
+        char* line, const char* prefix, const char* suffix, const char* format, va_list args) {
+        usize     length   = formatString(line, LOG_LINE_SIZE, "%s", prefix);
+        const i32 capacity = (i32)(LOG_LINE_SIZE - length - LOG_SUFFIX_SIZE);
+        const i32 message  = formatString(line + length, capacity, format, args);
+        length            += message < capacity ? message : capacity - 1;
+        length            += formatString(line + length, LOG_LINE_SIZE - length, "%s", suffix);
+        return length;
+    }
+
+    // Queues a message for the background logger. Lines from different threads may come out of
+    // order, the lines of one thread never do.
+    FROGENGINE_EXPORT void writeLog(
+        LogLevel level, LogChannel channel, const char* format, va_list args);
+    // Formats and writes everything queued so far before returning.
+    FROGENGINE_EXPORT void flushLog();
+    // Writes messages to a binary ring file of at most `_size` bytes instead of the terminal,
+    // until closeLogFile(). Errors still show on the terminal too. Returns false when the file
+    // can not be mapped or `_size` is too small to hold two blocks of records.
+    FROGENGINE_EXPORT bool openLogFile(const char* path, usize _size);
+    FROGENGINE_EXPORT void closeLogFile();
+    // Flushes the queues, writes the message, shows it in a message box on Windows and exits.
+    [[noreturn]] FROGENGINE_EXPORT void writeError(
+        LogChannel channel, const char* format, va_list args);
+
+    // writeLog() and writeError() for arguments the checked functions below pass on.
+    inline void logArguments(LogLevel level, LogChannel channel, const char* format, ...) {
+        va_list args;
+        va_start(args, format);
+        writeLog(level, channel, format, args);
+        va_end(args);
+    }
+    [[noreturn]] inline void logErrorArguments(LogChannel channel, const char* format, ...) {
+        va_list args;
+        va_start(args, format);
+        writeError(channel, format, args);
+    }
+
+    // Target of the FR_LOG_ macros, which check the level and channel first.
+    template <typename... Arguments>
+    inline void logMessage(
+        LogLevel                    level,
+        LogChannel                  channel,
+        CheckedFormat<Arguments...> format,
+        const Arguments&... arguments) {
+        logArguments(level, channel, format.text, passFormatArgument(arguments)...);
+    }
+
     /**
      * @brief Logs an informational message.
      *
@@ -73,17 +217,16 @@ namespace FrogEngine {
      *
      * @param format Null-terminated format string (printf-style).
      * @param ...   Variable arguments matching the format specifiers.
+     *
+     * @note Unlike FR_LOG_INFO(), the arguments are evaluated even when the level is compiled
+     * out.
      */
-    inline void logInfo(const char* format, ...) {
-#if defined(FR_DEBUG) || defined(FR_LOG)
-        char* args;
-
-        va_start(args, format);
-        printf("%s[INFO] %s", FR_LOG_FORMAT_GREEN, FR_LOG_FORMAT_RESET);
-        vprintf(format, args);
-        printf("\n%s", FR_LOG_FORMAT_RESET);
-        va_end(args);
-#endif
+    template <typename... Arguments>
+    inline void logInfo(CheckedFormat<Arguments...> format, const Arguments&... arguments) {
+        if constexpr (LOG_INFO >= FR_LOG_MIN_LEVEL) {
+            if (!isLogEnabled(CHANNEL_GENERAL, LOG_INFO)) return;
+            logArguments(LOG_INFO, CHANNEL_GENERAL, format.text, passFormatArgument(arguments)...);
+        }
     }
 
     /**
@@ -95,63 +238,39 @@ namespace FrogEngine {
      * @param format Null-terminated format string (printf-style).
      * @param ...   Variable arguments matching the format specifiers.
      */
-    inline void logWarning(const char* format, ...) {
-#if defined(FR_DEBUG) || defined(FR_LOG)
-        char* args;
-
-        va_start(args, format);
-        fprintf(stderr, "%s[WARNING] %s", FR_LOG_FORMAT_BRIGHT_YELLOW, FR_LOG_FORMAT_RESET);
-        vfprintf(stderr, format, args);
-        fprintf(stderr, "\n%s", FR_LOG_FORMAT_RESET);
-        va_end(args);
-#endif
+    template <typename... Arguments>
+    inline void logWarning(CheckedFormat<Arguments...> format, const Arguments&... arguments) {
+        if constexpr (LOG_WARNING >= FR_LOG_MIN_LEVEL) {
+            if (!isLogEnabled(CHANNEL_GENERAL, LOG_WARNING)) return;
+            logArguments(
+                LOG_WARNING, CHANNEL_GENERAL, format.text, passFormatArgument(arguments)...);
+        }
     }
-}
 
-#ifdef FR_OS_WINDOWS
-#    include <Windows.h>
-#endif
-/**
- * @brief Logs an error message.
- *
- * Reports critical failures that may affect program stability or correctness
- * (e.g., missing resources, invalid states, failed allocations).
- *
- * @param format Null-terminated format string (printf-style).
- * @param ...   Variable arguments matching the format specifiers.
- *
- * @note If called app will cleanly exit and abort.
- */
-namespace FrogEngine {
-    inline void logError(const char* format, ...) {
-#if defined(FR_DEBUG) || defined(FR_LOG)
-        char* args;
-
-        va_start(args, format);
-        int length = vsnprintf(0, 0, format, args);
-        va_end(args);
-        if (length >= 0) {
-            char* str = (char*)malloc(length + 10);
-            if (str) {
-                va_start(args, format);
-                vsnprintf(str + 8, length + 1, format, args);
-                va_end(args);
-                memcpy(str, "[ERROR] ", 8);
-                str[8 + length] = '\n';
-                str[9 + length] = 0;
-                printf(
-                    "%s%s%s%s",
-                    FR_LOG_FORMAT_BRIGHT_RED,
-                    FR_LOG_FORMAT_BOLD,
-                    FR_LOG_FORMAT_ITALIC,
-                    str);
-#    ifdef FR_OS_WINDOWS
-                MessageBoxA(nullptr, str, "Error", MB_OK | MB_ICONERROR);
-#    endif
-                free(str);
-            }
-        }
-#endif
+    /**
+     * @brief Logs an error message.
+     *
+     * Reports critical failures that may affect program stability or correctness
+     * (e.g., missing resources, invalid states, failed allocations).
+     *
+     * @param channel Subsystem reporting the error.
+     * @param format Null-terminated format string (printf-style).
+     * @param ...   Variable arguments matching the format specifiers.
+     *
+     * @note If called app will cleanly exit and abort.
+     */
+    template <typename... Arguments>
+    [[noreturn]] inline void logError(
+        LogChannel channel, CheckedFormat<Arguments...> format, const Arguments&... arguments) {
+        if constexpr (LOG_ERROR >= FR_LOG_MIN_LEVEL)
+            logErrorArguments(channel, format.text, passFormatArgument(arguments)...);
+        exit(-1);
+    }
+    template <typename... Arguments>
+    [[noreturn]] inline void logError(
+        CheckedFormat<Arguments...> format, const Arguments&... arguments) {
+        if constexpr (LOG_ERROR >= FR_LOG_MIN_LEVEL)
+            logErrorArguments(CHANNEL_GENERAL, format.text, passFormatArgument(arguments)...);
         exit(-1);
     }
 }
@@ -0,0 +1,111 @@
+/**
+ * @file LogFile.h
+ * @brief Binary Log Module
+ *
+ * Layout of the files openLogFile() writes, and the reader frlog-decode turns them back into
+ * messages with.
+ *
+ * A file starts with a header, then a table of every format string logged, each written once
+ * when first used with its level and channel, then a ring of fixed size blocks of records. A
+ * record holds the index of its format in the table, the time since the record before it, the
+ * thread that logged it and the arguments packed as varints, where the text line repeats the
+ * whole format and pads every number out to digits.
+ *
+ * The file is mapped shared, and counts are only raised with a release store after what they
+ * cover is written, so after a crash the file holds every record up to the last one committed.
+ * When the ring wraps, the oldest block is overwritten.
+ */
+#ifndef FROGENGINE_LOG_FILE_H
+#define FROGENGINE_LOG_FILE_H
+
+#include <FrogEngine/Log.h>
+#include <FrogEngine/Runtime.h>
+#include <FrogEngine/Utility.h>
+
+namespace FrogEngine {
+    constexpr u32   LOG_FILE_MAGIC { 0x47'4F'4C'46 }; ///< "FLOG"
+    constexpr u32   LOG_FILE_VERSION { 1 };
+    constexpr usize LOG_FILE_HEADER_SIZE { 4'096 };
+    constexpr usize LOG_FILE_TABLE_SIZE { 262'144 };
+    constexpr usize LOG_FILE_BLOCK_SIZE { 4'096 };
+    constexpr u32   LOG_FILE_MAX_SITES { 4'096 };
+    // The first sites are "%s" for every level and channel, at level * LOG_CHANNEL_COUNT +
+    // channel, for messages stored already formatted.
+    constexpr u32 LOG_FILE_TEXT_SITES { (LOG_ERROR + 1) * LOG_CHANNEL_COUNT };
+    // Thread of messages written synchronously by threads past the logger's ring limit.
+    constexpr u8 LOG_FILE_NO_THREAD { 0xFF };
+    // Largest argument layout a record decodes to, which holds a whole formatted line.
+    constexpr usize LOG_FILE_ARGUMENT_SIZE { LOG_LINE_SIZE + 16 };
+
+    struct LogFileHeader {
+        u32 magic;
+        u32 version;
+        u32 blockSize;
+        u32 blockCount;
+        u32 tableSize;
+        u32 tableUsed; ///< Bytes of sites after the offsets
+        u32 siteCount;
+        u32 reserved;
+        u64 startTime; ///< getTime() when the file was opened
+    };
+
+    // The table starts with LOG_FILE_MAX_SITES offsets of the sites that follow them, relative to
+    // the table. A site is a level byte and a channel byte, then the terminated format string.
+    struct LogFileTable {
+        u32 offsets[LOG_FILE_MAX_SITES];
+    };
+
+    // Records follow the block header. Each starts with a varint site, the zigzag varint
+    // nanoseconds since the record before it and the thread byte. The arguments come in the
+    // order of the format: INT as zigzag varints, UNSIGNED and POINTER as varints, FLOAT as 8
+    // raw bytes and TEXT as a varint length plus one, 0 for null, then the characters.
+    struct LogFileBlock {
+        u64 sequence; ///< 1 for the first block written, 0 while unused or being reset
+        u64 time;     ///< Time the first record's delta is from
+        u32 used;     ///< Bytes of records committed after the header
+        u32 reserved;
+    };
+
+    inline u8* writeVarint(u8* cursor, u64 value) {
+        while (value >= 0x80) {
+            *cursor++ = (u8)(value | 0x80);
+            value   >>= 7;
+        }
+        *cursor++ = (u8)value;
+        return cursor;
+    }
+    // Returns false when the varint runs past `end` or 10 bytes.
+    inline bool readVarint(const u8** cursor, const u8* end, u64* value) {
+        u64 result = 0;
+        for (u32 shift = 0; shift < 70 && *cursor < end; shift += 7) {
+            const u8 byte = *(*cursor)++;
+            result       |= (u64)(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                *value = result;
+                return true;
+            }
+        }
+        return false;
+    }
+    // Small negative numbers stay small: 0, -1, 1, -2 become 0, 1, 2, 3.
+    inline u64 encodeZigzag(i64 value) { return (u64)value << 1 ^ (u64)(value >> 63); }
+    inline i64 decodeZigzag(u64 value) { return (i64)(value >> 1) ^ -(i64)(value & 1); }
+
+    struct LogEntry {
+        u64         time; ///< Nanoseconds since the file was opened
+        LogLevel    level;
+        LogChannel  channel;
+        u8          thread; ///< Index of the thread, in the order threads first logged
+        const char* format;
+        const u8*   arguments; ///< Laid out like captureFormat(), for formatCaptured()
+    };
+
+    typedef void (*LogVisitor)(const LogEntry* entry, ptr user);
+
+    // Calls `visit` for every committed record of a log file, oldest first. A damaged block is
+    // skipped from the first record that does not decode. Returns false when `file` is not a
+    // log file.
+    FROGENGINE_EXPORT bool readLogFile(const u8* file, usize _size, LogVisitor visit, ptr user);
+}
+
+#endif
@@ -1,17 +1,24 @@
 #ifndef FROGENGINE_POINTER_H
 #define FROGENGINE_POINTER_H
 
-#if defined(FR_DEBUG) || defined(FR_MEMORY_SAFE)
-#    include <stdlib.h>
-#endif
-
 #include <FrogEngine/Log.h>
+#include <FrogEngine/Shadow.h>
 #include <FrogEngine/Utility.h>
 
+// FR_MEMORY_SHADOW checks accesses against shadow memory instead of carrying the bounds in every
+// pointer, so it takes precedence over the checks FR_DEBUG and FR_MEMORY_SAFE add.
+#if (defined(FR_DEBUG) || defined(FR_MEMORY_SAFE)) && !defined(FR_MEMORY_SHADOW)
+#    define FR_POINTER_BOUNDS
+#endif
+
 namespace FrogEngine {
     class StaticBlock;
     struct OsWindow;
 
+    // Pointers are a byte offset from a block's base address. Bounds are counted in elements of
+    // T, so arithmetic and indexing work like they do on T*. The allocator never moves its
+    // buffer, so defining FR_STABLE_POINTER caches the base address in the pointer and saves a
+    // load on every access.
     template <typename T>
     class Pointer {
       public:
@@ -19,8 +26,12 @@ namespace FrogEngine {
         explicit Pointer(
             usize _offset, uptr* _base, usize _size, ptr* _buffer, usize _negativeOffset) :
             offset(_offset),
+#ifdef FR_STABLE_POINTER
+            base(*_base)
+#else
             base(_base)
-#if defined(FR_DEBUG) || defined(FR_MEMORY_SAFE)
+#endif
+#ifdef FR_POINTER_BOUNDS
             ,
             size(_size),
             buffer(_buffer),
@@ -34,60 +45,75 @@ namespace FrogEngine {
         Pointer(const Pointer<U> &other) :
             offset(other.getOffset()),
             base(other.getBase())
-#if defined(FR_DEBUG) || defined(FR_MEMORY_SAFE)
+#ifdef FR_POINTER_BOUNDS
             ,
-            size(other.getSize()),
+            size(other.getSize() * sizeof(U) / sizeof(T)),
             buffer(other.getBuffer()),
-            negativeOffset(other.getNegativeOffset())
+            negativeOffset(other.getNegativeOffset() * sizeof(U) / sizeof(T))
 #endif
         {
         }
 
+#ifdef FR_STABLE_POINTER
+        T* get() const { return (T*)(offset + base); }
+#else
         T* get() const { return (T*)(offset + *base); }
+#endif
 
+#ifdef FR_MEMORY_SHADOW
+        T &operator*() const {
+            checkShadow(get(), sizeof(T));
+            return *get();
+        }
+        T* operator->() const {
+            checkShadow(get(), sizeof(T));
+            return get();
+        }
+#else
         T &operator*() const { return *get(); }
         T* operator->() const { return get(); }
+#endif
 
         Pointer operator+(usize n) const {
-#if defined(FR_DEBUG) || defined(FR_MEMORY_SAFE)
-            if (n > size) {
-                free(*buffer);
-                logError(
-                    "%sALLOCATOR%s: Tried to access out of bounds\n[ERROR]   This error will not "
-                    "be checked for in release",
-                    FR_LOG_FORMAT_YELLOW,
-                    FR_LOG_FORMAT_RESET);
-            } else return Pointer(offset + n, base, size - n, buffer, negativeOffset + n);
-#else
-            return Pointer(offset + n, base, 0, nullptr, 0);
+            Pointer result(*this);
+#ifdef FR_POINTER_BOUNDS
+            if (n > size)
+                FR_LOG_ERROR(
+                    ALLOCATOR,
+                    "Tried to access out of bounds\n[ERROR]   This error will not "
+                    "be checked for in release");
+            result.size           -= n;
+            result.negativeOffset += n;
 #endif
+            result.offset += n * sizeof(T);
+            return result;
         }
         Pointer operator-(usize n) const {
-#if defined(FR_DEBUG) || defined(FR_MEMORY_SAFE)
-            if (n > negativeOffset) {
-                free(*buffer);
-                logError(
-                    "%sALLOCATOR%s: Tried to access out of bounds\n[ERROR]   This error will not "
-                    "be checked for in release",
-                    FR_LOG_FORMAT_YELLOW,
-                    FR_LOG_FORMAT_RESET);
-            } else return Pointer(offset - n, base, size + n, buffer, negativeOffset - n);
-#else
-            return Pointer(offset - n, base, 0, nullptr, 0);
+            Pointer result(*this);
+#ifdef FR_POINTER_BOUNDS
+            if (n > negativeOffset)
+                FR_LOG_ERROR(
+                    ALLOCATOR,
+                    "Tried to access out of bounds\n[ERROR]   This error will not "
+                    "be checked for in release");
+            result.size           += n;
+            result.negativeOffset -= n;
 #endif
+            result.offset -= n * sizeof(T);
+            return result;
         }
 
         T &operator[](usize n) const {
-#if defined(FR_DEBUG) || defined(FR_MEMORY_SAFE)
+#ifdef FR_POINTER_BOUNDS
             if (n >= size) {
-                free(*buffer);
-                logError(
-                    "%sALLOCATOR%s: Tried to access out of bounds\n[ERROR]   This error will not "
-                    "be checked for in release",
-                    FR_LOG_FORMAT_YELLOW,
-                    FR_LOG_FORMAT_RESET);
+                FR_LOG_ERROR(
+                    ALLOCATOR,
+                    "Tried to access out of bounds\n[ERROR]   This error will not "
+                    "be checked for in release");
                 return get()[0];
             } else
+#elif defined(FR_MEMORY_SHADOW)
+            checkShadow(get() + n, sizeof(T));
 #endif
                 return get()[n];
         }
@@ -96,8 +122,12 @@ namespace FrogEngine {
         operator bool() const { return get() != nullptr; }
 
         usize getOffset() const { return offset; }
+#ifdef FR_STABLE_POINTER
+        uptr getBase() const { return base; }
+#else
         uptr* getBase() const { return base; }
-#if defined(FR_DEBUG) || defined(FR_MEMORY_SAFE)
+#endif
+#ifdef FR_POINTER_BOUNDS
         usize getSize() const { return size; }
         ptr*  getBuffer() const { return buffer; }
         usize getNegativeOffset() const { return negativeOffset; }
@@ -105,9 +135,13 @@ namespace FrogEngine {
 
       private:
         usize offset {};
+#ifdef FR_STABLE_POINTER
+        uptr base {};
+#else
         uptr* base {};
+#endif
 
-#if defined(FR_DEBUG) || defined(FR_MEMORY_SAFE)
+#ifdef FR_POINTER_BOUNDS
         usize size {};
         ptr*  buffer { nullptr };
         usize negativeOffset { 0 };
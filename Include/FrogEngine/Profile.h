@@ -0,0 +1,91 @@
+/**
+ * @file Profile.h
+ * @brief Profile Module
+ *
+ * CPU profiling zones. FR_PROFILE_SCOPE("name") times the rest of the enclosing scope with the
+ * processor's cycle counter and leaves one record in a ring of the calling thread, without locks
+ * or system calls. FR_PROFILE_FRAME() ends a frame: it records the frame itself as a zone and
+ * moves what every ring holds into the file openProfileFile() opened, as Chrome trace JSON that
+ * Perfetto and chrome://tracing open.
+ *
+ * Zones and frame marks are only compiled in with FR_PROFILE defined, for the engine as well as
+ * the application; otherwise they and their names disappear. Names are kept as pointers and read
+ * when the frame is written, so they have to be string literals.
+ */
+#ifndef FROGENGINE_PROFILE_H
+#define FROGENGINE_PROFILE_H
+
+#include <FrogEngine/Runtime.h>
+#include <FrogEngine/Utility.h>
+
+#define FR_PROFILE_CONCAT_INNER(a, b) a##b
+#define FR_PROFILE_CONCAT(a, b)       FR_PROFILE_CONCAT_INNER(a, b)
+
+#ifdef FR_PROFILE
+#    define FR_PROFILE_SCOPE(name) \
+        ::FrogEngine::ProfileScope FR_PROFILE_CONCAT(profileScope, __LINE__) { name }
+#    define FR_PROFILE_FRAME() ::FrogEngine::markProfileFrame()
+#else
+#    define FR_PROFILE_SCOPE(name) ((void)0)
+#    define FR_PROFILE_FRAME()     ((void)0)
+#endif
+
+namespace FrogEngine {
+    // Zones a thread can end between two frame marks. Further ones are dropped, and the trace
+    // shows how many.
+    constexpr u32 PROFILE_RING_SIZE { 4'096 };
+    // Threads past the first PROFILE_MAX_THREADS that end zones are not profiled.
+    constexpr u32 PROFILE_MAX_THREADS { 32 };
+
+    // The processor's cycle counter, rdtsc on x86 and the virtual counter on ARM. Only
+    // differences mean anything; the trace converts them to time.
+    inline u64 getCycles() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+        return __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+        u64 cycles;
+        __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(cycles));
+        return cycles;
+#else
+        return getTime();
+#endif
+    }
+
+    // Set while a profile file is open. Zones only read the counter then.
+    extern FROGENGINE_EXPORT u32 profileOpen;
+
+    inline bool isProfiling() { return __atomic_load_n(&profileOpen, __ATOMIC_RELAXED); }
+    // Records a zone of the calling thread that ran from `begin` until now. Does nothing while no
+    // profile file is open.
+    FROGENGINE_EXPORT void endProfileZone(const char* name, u64 begin);
+    // Records the frame since the last mark as a zone and writes every zone ended so far.
+    FROGENGINE_EXPORT void markProfileFrame();
+    // Writes zones to a Chrome trace file until closeProfileFile(). Returns false when the file
+    // can not be created.
+    FROGENGINE_EXPORT bool openProfileFile(const char* path);
+    FROGENGINE_EXPORT void closeProfileFile();
+
+    /**
+     * @class ProfileScope
+     * @brief Records a zone from its construction to its destruction.
+     *
+     * @note Use it through FR_PROFILE_SCOPE(), which compiles it out without FR_PROFILE.
+     */
+    class ProfileScope {
+      public:
+        explicit ProfileScope(const char* _name) :
+            name(_name), begin(isProfiling() ? getCycles() : 0) {}
+        ~ProfileScope() {
+            if (begin) endProfileZone(name, begin);
+        }
+
+        ProfileScope(const ProfileScope &)            = delete;
+        ProfileScope &operator=(const ProfileScope &) = delete;
+
+      private:
+        const char* name;
+        u64         begin;
+    };
+}
+
+#endif
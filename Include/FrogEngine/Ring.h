@@ -0,0 +1,99 @@
+/**
+ * @file Ring.h
+ * @brief Ring Module
+ *
+ * Lock free queues from many threads to one consumer. Every thread that produces claims a ring
+ * of a RingSet on first use and is the only producer of it, while a single consumer, usually
+ * whoever holds the module's lock, empties all of them. The logger and the profiler queue their
+ * records this way.
+ */
+#ifndef FROGENGINE_RING_H
+#define FROGENGINE_RING_H
+
+#include <FrogEngine/Utility.h>
+
+namespace FrogEngine {
+    /**
+     * @class Ring
+     * @brief Single producer, single consumer ring of `SIZE` elements.
+     *
+     * `head` and `tail` only grow and are reduced modulo the ring size on access. A producer that
+     * finds the ring full counts a drop instead of waiting, and the consumer reports the drops.
+     *
+     * @note Only for static storage, which starts out zeroed.
+     */
+    template <typename T, usize SIZE>
+    class Ring {
+      public:
+        T &operator[](u64 position) { return data[position % SIZE]; }
+
+        // Producer side.
+        u64  getHead() const { return head; }
+        u64  getTail() const { return __atomic_load_n(&tail, __ATOMIC_ACQUIRE); }
+        void publish(u64 _head) { __atomic_store_n(&head, _head, __ATOMIC_RELEASE); }
+        void drop() { __atomic_store_n(&dropped, dropped + 1, __ATOMIC_RELAXED); }
+
+        // Consumer side.
+        u64  getPublished() const { return __atomic_load_n(&head, __ATOMIC_ACQUIRE); }
+        u64  getConsumed() const { return tail; }
+        void consume(u64 _tail) { __atomic_store_n(&tail, _tail, __ATOMIC_RELEASE); }
+        bool hasDropped() const { return __atomic_load_n(&dropped, __ATOMIC_RELAXED) != reported; }
+        // Drops since the last call.
+        u64 takeDropped() {
+            const u64 total = __atomic_load_n(&dropped, __ATOMIC_RELAXED);
+            const u64 count = total - reported;
+            reported        = total;
+            return count;
+        }
+        // Discards everything published and dropped so far.
+        void skip() {
+            consume(getPublished());
+            takeDropped();
+        }
+
+      private:
+        alignas(64) u64 head;
+        u64 dropped;
+        alignas(64) u64 tail;
+        u64 reported;
+        alignas(64) T data[SIZE];
+    };
+
+    /**
+     * @class RingSet
+     * @brief One Ring for each of the first `COUNT` threads that produce.
+     *
+     * @note The claims of threads are kept per type, so each type of set is meant for a single
+     * set. Only for static storage, like Ring.
+     */
+    template <typename T, usize SIZE, u32 COUNT>
+    class RingSet {
+      public:
+        // The ring of the calling thread, or nullptr for threads past the first COUNT.
+        Ring<T, SIZE>* claim() {
+            if (!threadClaimed) {
+                const u32 index = __atomic_fetch_add(&claimed, 1, __ATOMIC_RELAXED);
+                threadRing      = index < COUNT ? &rings[index] : nullptr;
+                threadClaimed   = true;
+            }
+            return threadRing;
+        }
+
+        // Rings claimed so far.
+        u32 getCount() const {
+            const u32 count = __atomic_load_n(&claimed, __ATOMIC_ACQUIRE);
+            return count < COUNT ? count : COUNT;
+        }
+        Ring<T, SIZE>* getRing(u32 index) { return &rings[index]; }
+        u32            getIndex(const Ring<T, SIZE>* ring) const { return (u32)(ring - rings); }
+
+      private:
+        Ring<T, SIZE> rings[COUNT];
+        u32           claimed;
+
+        inline static thread_local Ring<T, SIZE>* threadRing;
+        inline static thread_local bool           threadClaimed;
+    };
+}
+
+#endif
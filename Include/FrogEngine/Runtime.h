@@ -0,0 +1,89 @@
+#ifndef FROGENGINE_RUNTIME_H
+#define FROGENGINE_RUNTIME_H
+
+#include <stdarg.h>
+
+#include <FrogEngine/Utility.h>
+
+namespace FrogEngine {
+    // The little of the C library the engine needs. Linux goes straight to system calls, so the
+    // engine links without libc when FrogStart provides the program entry. Other platforms wrap
+    // their C runtime.
+
+    typedef i32 FileHandle;
+
+    constexpr FileHandle FILE_NONE { -1 };
+    constexpr FileHandle FILE_OUTPUT { 1 };
+    constexpr FileHandle FILE_ERROR { 2 };
+
+    enum FileMode : u8 {
+        FILE_READ  = 0, ///< Existing file, read only
+        FILE_WRITE = 1, ///< Created or truncated, write only
+    };
+
+    FileHandle openFile(const char* path, FileMode mode);
+    i64        readFile(FileHandle file, ptr buffer, usize _size);
+    i64        writeFile(FileHandle file, const void* buffer, usize _size);
+    bool       seekFile(FileHandle file, usize offset);
+    bool       closeFile(FileHandle file);
+
+    // Returns 0 when the directory was created, otherwise the errno value, like EEXIST.
+    i32 makeDirectory(const char* path);
+
+    // errno value of the last failed file call on this thread.
+    i32 getLastError();
+
+#ifndef FR_OS_WINDOWS
+    // mmap() and friends with the <sys/mman.h> constants. mapMemory() returns nullptr on failure.
+    ptr  mapMemory(ptr address, usize _size, i32 protection, i32 flags);
+    bool unmapMemory(ptr address, usize _size);
+    bool protectMemory(ptr address, usize _size, i32 protection);
+    bool adviseMemory(ptr address, usize _size, i32 advice);
+#endif
+
+    // Maps a file shared, so what is written to it reaches the file even when the process dies.
+    // The file is created or truncated to `_size` bytes. Returns nullptr on failure.
+    ptr  mapFile(const char* path, usize _size);
+    bool unmapFile(ptr address, usize _size);
+
+    // Monotonic clock in nanoseconds from an unspecified starting point.
+    u64 getTime();
+
+    // Environment captured before any other constructor runs. Returns nullptr when unset.
+    const char* getEnvironment(const char* name);
+#ifdef FR_OS_LINUX
+    // Entry of the auxiliary vector the kernel passed, like AT_PAGESZ, or 0 when missing.
+    usize getAuxiliary(usize type);
+#endif
+
+    // printf style formatting for %d %i %u %x %X %o %p %s %c %f and %%, with flags, width,
+    // precision and the hh h l ll z j t length modifiers. Returns the length the full output
+    // would have and always terminates `buffer` when `_size` is not 0. Literal formats go through
+    // the formatString() of Format.h, which checks them against the arguments.
+    i32 formatString(char* buffer, usize _size, const char* format, va_list args);
+    i32 formatArguments(char* buffer, usize _size, const char* format, ...)
+        __attribute__((format(printf, 3, 4)));
+
+    // Copies the arguments `format` consumes into `buffer`, strings included, so
+    // formatCaptured() can format them later on another thread. Returns the bytes used, or -1
+    // when they do not fit.
+    i64 captureFormat(u8* buffer, usize _size, const char* format, va_list args);
+    i32 formatCaptured(char* buffer, usize _size, const char* format, const u8* arguments);
+
+    // How captureFormat() stores each argument. Integers and pointers take one 8 byte slot, as
+    // does the bit pattern of a float, sign extended for ARGUMENT_INT.
+    enum FormatArgument : u8 {
+        ARGUMENT_INT,
+        ARGUMENT_UNSIGNED,
+        ARGUMENT_FLOAT,
+        ARGUMENT_POINTER,
+        ARGUMENT_TEXT, ///< Length slot, then the text and a terminator padded to 8 bytes
+    };
+    constexpr u64 CAPTURE_NULL_TEXT { ~0ull }; ///< Length slot of a null string
+
+    // Kinds of the arguments `format` consumes, in order. Returns how many there are, which may
+    // be more than the `max` written to `kinds`.
+    u32 getFormatArguments(const char* format, FormatArgument* kinds, u32 max);
+}
+
+#endif
@@ -8,11 +8,20 @@ namespace FrogEngine {
     class Allocator;
     class StaticBlock;
 
+    // Arena sizes learned from previous runs. Bump the version whenever the layout changes and
+    // teach readEngineCache() how to migrate the old one.
     struct EngineCache {
-        u32   version { 1 };
+        u32   version { 2 };
         usize allocatorCache { 1'024 };
+        usize staticCache { 2'144 };
+        usize frameCache { 4'096 };
     };
 
+    // Returns the version found on disk, or 0 if the file is missing or unreadable. Older
+    // versions are migrated into the current layout.
+    FROGENGINE_EXPORT u32  readEngineCache(const char* path, EngineCache* cache);
+    FROGENGINE_EXPORT bool writeEngineCache(const char* path, const EngineCache* cache);
+
     class FROGENGINE_EXPORT Save {
       public:
         Save(Allocator* allocator);
@@ -21,6 +30,7 @@ namespace FrogEngine {
         void init();
 
       private:
+        Allocator*   allocator {};
         StaticBlock* block {};
 
         u32           id {};
@@ -0,0 +1,87 @@
+#ifndef FROGENGINE_SHADOW_H
+#define FROGENGINE_SHADOW_H
+
+#include <FrogEngine/Utility.h>
+
+#if defined(__SANITIZE_ADDRESS__)
+#    define FR_ASAN
+#elif defined(__has_feature)
+#    if __has_feature(address_sanitizer)
+#        define FR_ASAN
+#    endif
+#endif
+#ifdef FR_ASAN
+#    include <sanitizer/asan_interface.h>
+#endif
+
+#if defined(FR_MEMORY_SHADOW) || defined(FR_ASAN)
+#    define FR_MEMORY_POISON
+#endif
+
+namespace FrogEngine {
+    constexpr usize SHADOW_GRANULE { 16 };
+    constexpr u32   SHADOW_SHIFT { 4 };
+    constexpr u8    SHADOW_FREED_PATTERN { 0xDD };
+
+    // A shadow byte of 0 means the whole granule is addressable and 1 to 15 means only that many
+    // leading bytes are. Anything else says why the granule is off limits.
+    enum ShadowKind : u8 {
+        SHADOW_ADDRESSABLE = 0x00,
+        SHADOW_UNALLOCATED = 0xF8, ///< Not handed out yet
+        SHADOW_REDZONE     = 0xFA, ///< Allocator metadata and padding around allocations
+        SHADOW_FREED       = 0xFD, ///< Freed and not reused yet
+    };
+
+    struct ShadowMap {
+        uptr start {};
+        uptr end {};
+        u8*  shadow { nullptr };
+    };
+
+#ifdef FR_MEMORY_SHADOW
+    // One arena at a time is checked. Accesses outside it are not.
+    FROGENGINE_EXPORT extern ShadowMap shadowMap;
+
+    void mapShadow(ptr arena, usize _size);
+    void commitShadow(usize _size);
+    void unmapShadow(ptr arena);
+    void setShadow(ptr address, usize _size, u8 kind);
+
+    FROGENGINE_EXPORT void reportShadow(const void* address, usize _size);
+
+    // Checks that `_size` bytes at `address` are addressable. The common case of an access
+    // inside one addressable granule is a subtraction, a compare and a load.
+    inline void checkShadow(const void* address, usize _size) {
+        const uptr offset = (uptr)address - shadowMap.start;
+        if (offset >= shadowMap.end - shadowMap.start) return;
+        if (!shadowMap.shadow[offset >> SHADOW_SHIFT] && (offset & 15) + _size <= SHADOW_GRANULE)
+            return;
+        reportShadow(address, _size);
+    }
+#endif
+
+    // Makes `_size` bytes at `address` addressable.
+    inline void unpoisonMemory(ptr address, usize _size) {
+#ifdef FR_MEMORY_SHADOW
+        setShadow(address, _size, SHADOW_ADDRESSABLE);
+#endif
+#ifdef FR_ASAN
+        ASAN_UNPOISON_MEMORY_REGION(address, _size);
+#endif
+        (void)address, (void)_size;
+    }
+    // Makes `_size` bytes at `address` inaccessible to the program. The allocator keeps its own
+    // data in the first `metadata` bytes, so AddressSanitizer leaves those readable.
+    inline void poisonMemory(ptr address, usize _size, ShadowKind kind, usize metadata = 0) {
+#ifdef FR_MEMORY_SHADOW
+        setShadow(address, _size, kind);
+#endif
+#ifdef FR_ASAN
+        ASAN_UNPOISON_MEMORY_REGION(address, metadata < _size ? metadata : _size);
+        if (metadata < _size) ASAN_POISON_MEMORY_REGION((u8*)address + metadata, _size - metadata);
+#endif
+        (void)address, (void)_size, (void)kind, (void)metadata;
+    }
+}
+
+#endif
@@ -0,0 +1,97 @@
+/**
+ * @file StringId.h
+ * @brief String ID Module
+ *
+ * Names like assets, events and log channels are identified by the 64 bit FNV-1a hash of their
+ * text. FR_SID() hashes literals at compile time and StringTable interns strings only known at
+ * runtime, so hot paths compare integers instead of strings.
+ */
+#ifndef FROGENGINE_STRING_ID_H
+#define FROGENGINE_STRING_ID_H
+
+#include <FrogEngine/Allocator.h>
+#include <FrogEngine/Atomic.h>
+#include <FrogEngine/Hash.h>
+#include <FrogEngine/HashMap.h>
+#include <FrogEngine/Pointer.h>
+#include <FrogEngine/Utility.h>
+
+// ID of a string literal, computed at compile time.
+#define FR_SID(text) (::FrogEngine::StringIdConstant<::FrogEngine::hashString(text)>::value)
+
+namespace FrogEngine {
+    struct StringId {
+        u64 value {};
+
+        constexpr bool operator==(StringId other) const { return value == other.value; }
+        constexpr bool operator!=(StringId other) const { return value != other.value; }
+        constexpr explicit operator bool() const { return value != 0; }
+    };
+
+    // Forces a hash into a constant expression, so FR_SID() never hashes at runtime.
+    template <u64 VALUE>
+    struct StringIdConstant {
+        static constexpr StringId value { VALUE };
+    };
+
+    // The ID is already a hash; it only needs mixing for HashMap.
+    template <>
+    struct Hash<StringId> {
+        u64 operator()(StringId id) const { return mixHash(id.value); }
+    };
+
+    constexpr usize STRING_PAGE_SIZE { 16'384 };
+
+    /**
+     * @class StringTable
+     * @brief Interns strings into an arena of dynamic memory.
+     *
+     * Every unique string is copied once into pages that are only freed with the table, so text
+     * returned by getString() stays valid as long as the table. IDs equal FR_SID() of the same
+     * text.
+     *
+     * @note intern() and getString() take a spin lock, so any thread may call them.
+     */
+    class FROGENGINE_EXPORT StringTable {
+      public:
+        StringTable(Allocator* _allocator);
+        ~StringTable();
+
+        StringTable(const StringTable &)            = delete;
+        StringTable &operator=(const StringTable &) = delete;
+
+        StringId intern(const char* text);
+        StringId intern(const char* text, usize length);
+
+        // Reverse lookup for debugging and tools. Returns nullptr for IDs that were never
+        // interned, including FR_SID() literals no one passed to intern().
+        const char* getString(StringId id);
+
+        usize getCount() const;
+        usize getBytes() const;
+
+      private:
+        struct Entry {
+            Pointer<char> text;
+            usize         length {};
+        };
+        // Start of every page, linking it to the one before.
+        struct PageHeader {
+            Pointer<u8> previous;
+            usize       previousSize {};
+        };
+
+        Pointer<char> store(const char* text, usize length);
+
+        DynamicBlock* block { nullptr };
+        SpinLock      lock;
+
+        HashMap<StringId, Entry> entries;
+        Pointer<u8>              page;
+        usize                    pageSize {};
+        usize                    pageUsed {};
+        usize                    bytes {};
+    };
+}
+
+#endif
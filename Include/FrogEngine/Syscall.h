@@ -0,0 +1,91 @@
+#ifndef FROGENGINE_SYSCALL_H
+#define FROGENGINE_SYSCALL_H
+
+#include <FrogEngine/Utility.h>
+
+#ifdef FR_OS_LINUX
+namespace FrogEngine {
+    // Linux system call numbers used by the engine. They differ between architectures.
+    enum SyscallNumber : i64 {
+#    if defined(__x86_64__)
+        SYSCALL_READ              = 0,
+        SYSCALL_WRITE             = 1,
+        SYSCALL_CLOSE             = 3,
+        SYSCALL_LSEEK             = 8,
+        SYSCALL_MMAP              = 9,
+        SYSCALL_MPROTECT          = 10,
+        SYSCALL_MUNMAP            = 11,
+        SYSCALL_SCHED_YIELD       = 24,
+        SYSCALL_MADVISE           = 28,
+        SYSCALL_NANOSLEEP         = 35,
+        SYSCALL_CLONE             = 56,
+        SYSCALL_EXIT              = 60,
+        SYSCALL_FTRUNCATE         = 77,
+        SYSCALL_ARCH_PRCTL        = 158,
+        SYSCALL_GETTID            = 186,
+        SYSCALL_FUTEX             = 202,
+        SYSCALL_SCHED_GETAFFINITY = 204,
+        SYSCALL_CLOCK_GETTIME     = 228,
+        SYSCALL_CLOCK_NANOSLEEP   = 230,
+        SYSCALL_EXIT_GROUP        = 231,
+        SYSCALL_OPENAT            = 257,
+        SYSCALL_MKDIRAT           = 258,
+#    elif defined(__aarch64__)
+        SYSCALL_MKDIRAT           = 34,
+        SYSCALL_FTRUNCATE         = 46,
+        SYSCALL_OPENAT            = 56,
+        SYSCALL_CLOSE             = 57,
+        SYSCALL_LSEEK             = 62,
+        SYSCALL_READ              = 63,
+        SYSCALL_WRITE             = 64,
+        SYSCALL_EXIT              = 93,
+        SYSCALL_EXIT_GROUP        = 94,
+        SYSCALL_FUTEX             = 98,
+        SYSCALL_NANOSLEEP         = 101,
+        SYSCALL_CLOCK_GETTIME     = 113,
+        SYSCALL_CLOCK_NANOSLEEP   = 115,
+        SYSCALL_SCHED_GETAFFINITY = 123,
+        SYSCALL_SCHED_YIELD       = 124,
+        SYSCALL_GETTID            = 178,
+        SYSCALL_MUNMAP            = 215,
+        SYSCALL_CLONE             = 220,
+        SYSCALL_MMAP              = 222,
+        SYSCALL_MPROTECT          = 226,
+        SYSCALL_MADVISE           = 233,
+#    else
+#        error "Unsupported architecture for Linux system calls"
+#    endif
+    };
+
+    // Raw system call without libc. Failures return -errno instead of setting errno.
+    inline i64 systemCall(
+        SyscallNumber number, i64 a = 0, i64 b = 0, i64 c = 0, i64 d = 0, i64 e = 0, i64 f = 0) {
+#    if defined(__x86_64__)
+        i64          result;
+        register i64 r10 asm("r10") = d;
+        register i64 r8 asm("r8")   = e;
+        register i64 r9 asm("r9")   = f;
+        asm volatile("syscall"
+                     : "=a"(result)
+                     : "a"(number), "D"(a), "S"(b), "d"(c), "r"(r10), "r"(r8), "r"(r9)
+                     : "rcx", "r11", "memory");
+        return result;
+#    elif defined(__aarch64__)
+        register i64 x8 asm("x8") = number;
+        register i64 x0 asm("x0") = a;
+        register i64 x1 asm("x1") = b;
+        register i64 x2 asm("x2") = c;
+        register i64 x3 asm("x3") = d;
+        register i64 x4 asm("x4") = e;
+        register i64 x5 asm("x5") = f;
+        asm volatile("svc 0"
+                     : "+r"(x0)
+                     : "r"(x8), "r"(x1), "r"(x2), "r"(x3), "r"(x4), "r"(x5)
+                     : "memory");
+        return x0;
+#    endif
+    }
+}
+#endif
+
+#endif
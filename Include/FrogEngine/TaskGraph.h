@@ -0,0 +1,154 @@
+/**
+ * @file TaskGraph.h
+ * @brief TaskGraph Module
+ *
+ * A frame described as a graph of tasks that is built once and replayed every frame on the job
+ * system. Tasks declare the resources they read and write; build() turns the declaration order
+ * and those accesses into dependencies inside a frame and between consecutive frames, so frame
+ * N+1 starts the tasks that do not conflict with what frame N is still running.
+ */
+#ifndef FROGENGINE_TASKGRAPH_H
+#define FROGENGINE_TASKGRAPH_H
+
+#include <FrogEngine/Job.h>
+#include <FrogEngine/Utility.h>
+
+#include <new>
+
+namespace FrogEngine {
+    constexpr u32   TASK_MAX_COUNT { 64 };
+    constexpr u32   TASK_MAX_RESOURCES { 64 };
+    constexpr u32   TASK_FRAMES_IN_FLIGHT { 2 };
+    constexpr usize TASK_PAYLOAD_SIZE { JOB_PAYLOAD_SIZE };
+    constexpr u32   TASK_NONE { ~0u };
+
+    // Bit i is set for task i or resource i.
+    typedef u64 TaskMask;
+    typedef u64 ResourceMask;
+
+    struct TaskTiming {
+        const char* name { nullptr };
+        f64         lastMs {};
+        f64         averageMs {};
+        // How much longer the task could take before it lengthens the frame. Tasks on the
+        // critical path have none.
+        f64 slackMs {};
+    };
+
+    /**
+     * @class TaskGraph
+     * @brief Runs a fixed graph of tasks once per frame.
+     *
+     * Tasks are ordered by declaration: a task depends on every earlier task it conflicts with,
+     * meaning one writes a resource the other reads or writes. Between frames every task
+     * depends on the tasks of the previous frame it conflicts with, and on itself, so up to
+     * TASK_FRAMES_IN_FLIGHT frames overlap wherever their resources allow. Ready tasks start in
+     * order of the longest measured path to the end of the frame, and a finishing task continues
+     * straight into its most critical successor.
+     *
+     * @note Call everything from the thread that called JobSystem::init().
+     */
+    class FROGENGINE_EXPORT TaskGraph {
+      public:
+        TaskGraph(JobSystem* _jobs);
+        ~TaskGraph();
+
+        TaskGraph(const TaskGraph &)            = delete;
+        TaskGraph &operator=(const TaskGraph &) = delete;
+
+        // Returns the bit of a new resource, or 0 when all TASK_MAX_RESOURCES are taken.
+        ResourceMask addResource();
+
+        // Adds a task calling function(u64 frame). Returns its index, or TASK_NONE when the
+        // graph is full or already built.
+        template <typename F>
+        u32 addTask(const char* name, ResourceMask reads, ResourceMask writes, F function) {
+            static_assert(sizeof(F) <= TASK_PAYLOAD_SIZE, "Capture large state by pointer");
+            static_assert(alignof(F) <= alignof(u64), "Closure is over aligned");
+
+            Task* task = createTask(name, reads, writes);
+            if (!task) return TASK_NONE;
+            task->invoke  = [](ptr payload, u64 frame) { (*(F*)payload)(frame); };
+            task->destroy = [](ptr payload) { ((F*)payload)->~F(); };
+            new (task->payload) F(function);
+            return taskCount++;
+        }
+        // Orders two tasks that share no resource. `before` must have been added first.
+        void addDependency(u32 before, u32 after);
+
+        // Derives the dependencies. Returns false when the graph is empty or already built.
+        bool build();
+
+        // Starts the next frame once the frame TASK_FRAMES_IN_FLIGHT before it has finished,
+        // and returns without waiting for it.
+        void beginFrame();
+        // Waits for every started frame.
+        void waitFrames();
+
+        // Number of frames started so far.
+        u64 getFrame() const;
+        u32 getTaskCount() const;
+
+        // Timings of the last finished frame, averaged over recent frames.
+        TaskTiming getTiming(u32 task) const;
+        f64        getCriticalPathMs() const;
+        void       logTimings() const;
+
+      private:
+        static constexpr u32 FRAME_SLOTS { TASK_FRAMES_IN_FLIGHT + 1 };
+
+        struct Task {
+            const char*  name { nullptr };
+            ResourceMask reads {};
+            ResourceMask writes {};
+            void (*invoke)(ptr payload, u64 frame) { nullptr };
+            void (*destroy)(ptr payload) { nullptr };
+            alignas(u64) u8 payload[TASK_PAYLOAD_SIZE];
+        };
+        // Everything one frame in flight writes. Slots are reused every FRAME_SLOTS frames.
+        struct alignas(CACHE_LINE_SIZE) FrameSlot {
+            u32        pending[TASK_MAX_COUNT] {};
+            JobCounter remaining;
+            u64        frame {};
+            u64        start[TASK_MAX_COUNT] {};
+            u64        end[TASK_MAX_COUNT] {};
+        };
+
+        Task* createTask(const char* name, ResourceMask reads, ResourceMask writes);
+        void  prepareSlot(u64 frame);
+        void  collectTimings(u64 until);
+        void  updatePriorities();
+
+        void sortReady(u32* ready, u32 count) const;
+        void launch(const u32* ready, u32 count, u32 slot);
+        void runTask(u32 task, u32 slot);
+
+        JobSystem* jobs { nullptr };
+
+        Task      tasks[TASK_MAX_COUNT];
+        u32       taskCount {};
+        u32       resourceCount {};
+        TaskMask  explicitPredecessors[TASK_MAX_COUNT] {};
+        bool      built {};
+        FrameSlot slots[FRAME_SLOTS];
+        u64       nextFrame {};
+
+        // Dependencies inside a frame and on the next frame, without redundant edges.
+        TaskMask successors[TASK_MAX_COUNT] {};
+        TaskMask nextSuccessors[TASK_MAX_COUNT] {};
+        u32      predecessorCount[TASK_MAX_COUNT] {};
+        u32      previousCount[TASK_MAX_COUNT] {};
+
+        // Nanoseconds. `priority` is the longest path from the start of a task to the end of the
+        // frame, and `head` the longest path from the start of the frame to the task.
+        u64 lastCost[TASK_MAX_COUNT] {};
+        u64 averageCost[TASK_MAX_COUNT] {};
+        u64 priority[TASK_MAX_COUNT] {};
+        u64 head[TASK_MAX_COUNT] {};
+        u64 criticalPath {};
+        u64 lastFrameCost {};
+        u64 timedFrames {};
+    };
+}
+
+#endif
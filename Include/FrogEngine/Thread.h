@@ -0,0 +1,65 @@
+/**
+ * @file Thread.h
+ * @brief Thread Module
+ *
+ * OS threads and the address based waiting that idle workers sleep on. Linux creates threads
+ * with clone() and gives each one a copy of the executable's thread local storage, unless the C
+ * library is linked, in which case it creates them so it can set up its own per thread state.
+ */
+#ifndef FROGENGINE_THREAD_H
+#define FROGENGINE_THREAD_H
+
+#include <FrogEngine/Utility.h>
+
+namespace FrogEngine {
+    constexpr usize THREAD_STACK_SIZE { 1'048'576 };
+
+    typedef void (*ThreadFunction)(ptr argument);
+
+    /**
+     * @class Thread
+     * @brief Runs a function on its own OS thread.
+     *
+     * @note The destructor joins a thread that is still running.
+     */
+    class FROGENGINE_EXPORT Thread {
+      public:
+        Thread();
+        ~Thread();
+
+        Thread(const Thread &)            = delete;
+        Thread &operator=(const Thread &) = delete;
+
+        // Returns false when the OS refuses to create the thread.
+        bool start(ThreadFunction _function, ptr _argument, usize stack_size = THREAD_STACK_SIZE);
+        void join();
+        bool isRunning() const;
+
+      private:
+        ThreadFunction function { nullptr };
+        ptr            argument { nullptr };
+        bool           running {};
+
+#ifdef FR_OS_WINDOWS
+        ptr handle { nullptr };
+#else
+        // Either a C library thread, or a clone() with its stack and storage in `block`. The
+        // kernel clears `id` when a cloned thread exits.
+        u64   library {};
+        ptr   block { nullptr };
+        usize blockSize {};
+        u32   id {};
+#endif
+    };
+
+    // Cores this process may run on.
+    FROGENGINE_EXPORT u32  getCoreCount();
+    FROGENGINE_EXPORT void yieldThread();
+
+    // Sleeps while `*address` equals `expected`. May return early, so callers re-check.
+    FROGENGINE_EXPORT void waitAddress(u32* address, u32 expected);
+    // Wakes up to `count` threads sleeping on `address`.
+    FROGENGINE_EXPORT void wakeAddress(u32* address, u32 count);
+}
+
+#endif
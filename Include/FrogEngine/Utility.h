@@ -33,6 +33,7 @@
 #    define FR_RELEASE
 #endif
 
+#include <stddef.h>
 #include <stdint.h>
 
 typedef int8_t  i8;
@@ -0,0 +1,24 @@
+#ifndef FROGENGINE_VIRTUAL_MEMORY_H
+#define FROGENGINE_VIRTUAL_MEMORY_H
+
+#include <FrogEngine/Utility.h>
+
+namespace FrogEngine {
+    constexpr usize HUGE_PAGE_SIZE { 2'097'152 };
+
+    // Reserved ranges take address space only and are aligned to HUGE_PAGE_SIZE where the
+    // platform allows it. Pages have to be committed before use and read as zero the first time
+    // they are touched.
+    usize getPageSize();
+    ptr   reserveMemory(usize _size);
+    bool  commitMemory(ptr address, usize _size);
+    void  releaseMemory(ptr address, usize _size);
+
+    // Huge page support. Each call returns false when the platform or system configuration
+    // cannot provide huge pages, in which case normal pages should be used instead.
+    bool hasTransparentHugePages();
+    bool adviseHugePages(ptr address, usize _size);
+    bool commitHugePages(ptr address, usize _size);
+}
+
+#endif
@@ -9,6 +9,7 @@
 #ifndef FROGENGINE_WINDOW_H
 #define FROGENGINE_WINDOW_H
 
+#include <FrogEngine/Format.h>
 #include <FrogEngine/Pointer.h>
 #include <FrogEngine/Utility.h>
 
@@ -25,6 +26,7 @@ namespace FrogEngine {
     struct OsWindow;
     class Allocator;
     class StaticBlock;
+    class FrameBlock;
 
     constexpr u32 MAX_INPUT_POLLING { 16 };
 
@@ -114,6 +116,9 @@ namespace FrogEngine {
          * @return true if the window should continue running, false if quit has been requested.
          *
          * Should be called once per frame. Updates input state and dispatches events.
+         *
+         * @note Starts a new frame in frame memory, releasing allocations from two frames ago,
+         * and with FR_PROFILE writes the profiling zones of the frame that ended.
          */
         bool pollEvents();
 
@@ -123,6 +128,16 @@ namespace FrogEngine {
          * @param title Null-terminated string for the new title.
          */
         void setWindowTitle(const char* title);
+        /**
+         * @brief Formats the window title, like setWindowTitle("Frog %u fps", fps).
+         * @param format Format checked against the arguments, see Format.h.
+         */
+        template <typename... Arguments>
+        void setWindowTitle(CheckedFormat<Arguments...> format, const Arguments&... arguments) {
+            char title[sizeof(windowTitle)];
+            formatString(title, sizeof(title), format, arguments...);
+            setWindowTitle(title);
+        }
         /**
          * @brief Sets the window position on screen.
          * @param x New X coordinate in screen space
@@ -308,6 +323,7 @@ namespace FrogEngine {
 
       private:
         StaticBlock* block {};
+        FrameBlock*  frameBlock {};
 
         char windowTitle[128] = { 0 };
         char className[16]    = { 0 };
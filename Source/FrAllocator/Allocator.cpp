@@ -1,122 +1,159 @@
-#include <stdio.h>
-#include <stdlib.h>
-
 #include <FrogEngine/Allocator.h>
+#include <FrogEngine/Format.h>
+#include <FrogEngine/Hash.h>
 #include <FrogEngine/Log.h>
+#include <FrogEngine/Profile.h>
+#include <FrogEngine/Runtime.h>
 #include <FrogEngine/Save.h>
+#include <FrogEngine/Shadow.h>
 #include <FrogEngine/Utility.h>
-
-u32 generateHash(const char* name) {
-    u32 hash = 5'381;
-    u8  c;
-
-    while ((c = *name++)) hash = ((hash << 5) + hash) + c;
-
-    return hash;
-}
+#include <FrogEngine/VirtualMemory.h>
 
 namespace FrogEngine {
-    Allocator::Allocator() : staticBlock(this), dynamicBlock(this) {}
+    Allocator::Allocator() :
+        staticBlock(this), frameBlock(this), dynamicBlock(this), poolBlock(this) {}
     Allocator::~Allocator() {
-        free(buffer);
-        logInfo(
-            "%sALLOCATOR%s: Deallocated %zu bytes",
-            FR_LOG_FORMAT_YELLOW,
-            FR_LOG_FORMAT_RESET,
-            size);
+#ifdef FR_MEMORY_SHADOW
+        unmapShadow(buffer);
+#endif
+        releaseMemory(buffer, reserveSize);
+        FR_LOG_INFO(ALLOCATOR, "Deallocated %zu bytes", size);
     }
 
-    void Allocator::init(const char* name) {
-        char* path = (char*)malloc(512);
-        if (!path)
-            logError(
-                "%sALLOCATOR%s: Failed to allocate path",
-                FR_LOG_FORMAT_YELLOW,
-                FR_LOG_FORMAT_RESET);
-        memset(path, 0, 512);
+    void Allocator::init(const char* name, AllocatorPages _pages) {
+        FR_PROFILE_SCOPE("Allocator::init");
+        char path[512] = { 0 };
 
         const char* base_path { nullptr };
 #ifdef FR_OS_WINDOWS
-        base_path = getenv("LOCALAPPDATA");
+        base_path = getEnvironment("LOCALAPPDATA");
 #else
-        base_path = getenv("XDG_CONFIG_HOME");
-        if (!basePath) {
-            base_path = getenv("HOME");
+        base_path = getEnvironment("XDG_CONFIG_HOME");
+        if (!base_path) {
+            base_path = getEnvironment("HOME");
             if (!base_path)
-                logError(
-                    "%sSAVE%s: Neither XDG_CONFIG_HOME nor HOME is set",
-                    FR_LOG_FORMAT_CYAN,
-                    FR_LOG_FORMAT_RESET);
+                FR_LOG_ERROR(SAVE, "Neither XDG_CONFIG_HOME nor HOME is set");
         }
 #endif
-        id = generateHash(name);
-        snprintf(path, 512, "%s\\FrogEngine\\%u\\engine.cache", base_path, id);
+        id = hashDjb2(name);
+        formatString(path, 512, "%s/FrogEngine/%u/engine.cache", base_path, id);
 
-        logInfo("%sALLOCATOR%s: Generated App ID", FR_LOG_FORMAT_YELLOW, FR_LOG_FORMAT_RESET);
-        logInfo("  ID: %u", id);
+        FR_LOG_INFO(ALLOCATOR, "Generated App ID");
+        FR_LOG_INFO(ALLOCATOR, "  ID: %u", id);
 
-        FILE*       file = fopen(path, "rb");
+        // Sizes learned by previous runs. Static and frame memory cannot grow, so they never
+        // drop below their defaults.
         EngineCache cache {};
-        EngineCache current {};
-        if (!file || fread(&cache, sizeof(EngineCache), 1, file) != 1) cache = {};
-        else if (file) fclose(file);
-        if (cache.version != current.version) cache = {};
-        free(path);
+        if (!readEngineCache(path, &cache)) cache = {};
+        if (cache.staticCache > staticSize) staticSize = cache.staticCache;
+        if (cache.frameCache > frameSize) frameSize = cache.frameCache;
 
         dynamicSize = cache.allocatorCache;
-        size        = staticSize + dynamicSize;
+        size        = staticSize + frameSize * 2 + dynamicSize;
 
-        buffer = malloc(size + 256);
+        // Reserve address space for the largest arena up front so growing only commits pages
+        // and the buffer never moves.
+        buffer = reserveMemory(reserveSize);
         if (!buffer)
-            logError(
-                "%sALLOCATOR%s: Failed to allocate buffer",
-                FR_LOG_FORMAT_YELLOW,
-                FR_LOG_FORMAT_RESET);
-        memset(buffer, 0, size + 256);
+            FR_LOG_ERROR(ALLOCATOR, "Failed to reserve %zu bytes of address space", reserveSize);
+#ifdef FR_MEMORY_SHADOW
+        mapShadow(buffer, reserveSize);
+#endif
+        setPages(_pages);
+        commit(size + 256);
+        poisonMemory(buffer, committed, SHADOW_REDZONE);
 
-        logInfo(
-            "%sALLOCATOR%s: Allocated %zu bytes", FR_LOG_FORMAT_YELLOW, FR_LOG_FORMAT_RESET, size);
+        FR_LOG_INFO(ALLOCATOR, "Allocated %zu bytes", size);
 
-        uptr index = (uptr)buffer + 15 & ~15;
+        // Regions start on cache lines so aligned allocations waste no padding up front.
+        uptr index = alignUp((uptr)buffer, CACHE_LINE_SIZE);
         staticBlock.init((ptr)index, staticSize);
         index += staticSize + 32;
-        logInfo("  %zu for static memory", staticSize);
+        FR_LOG_INFO(ALLOCATOR, "  %zu for static memory", staticSize);
+
+        index = alignUp(index, CACHE_LINE_SIZE);
+        frameBlock.init((ptr)index, frameSize);
+        index += frameSize * 2 + 32;
+        FR_LOG_INFO(ALLOCATOR, "  %zu for frame memory", frameSize * 2);
 
-        index = index + 15 & ~15;
+        index = alignUp(index, CACHE_LINE_SIZE);
         dynamicBlock.init((ptr)index, dynamicSize);
-        logInfo("  %zu for dynamic memory", dynamicSize);
+        FR_LOG_INFO(ALLOCATOR, "  %zu for dynamic memory", dynamicSize);
     }
     void Allocator::resize(usize _size) {
-        size   = _size;
-        buffer = realloc(buffer, size + 256);
-        if (!buffer)
-            logError(
-                "%sALLOCATOR%s: Failed to reallocate buffer",
-                FR_LOG_FORMAT_YELLOW,
-                FR_LOG_FORMAT_RESET);
-        logInfo(
-            "%sALLOCATOR%s: Reallocated buffer to %zu bytes",
-            FR_LOG_FORMAT_YELLOW,
-            FR_LOG_FORMAT_RESET,
-            size);
-
-        uptr index = (uptr)buffer + 15 & ~15;
-        staticBlock.setBuffer(buffer);
-        index += staticSize + 32;
-        logInfo("  %zu for static memory", staticSize);
-
-        index = index + 15 & ~15;
-        dynamicBlock.init((ptr)index, dynamicSize);
-        logInfo("  %zu for dynamic memory", dynamicSize);
+        FR_PROFILE_SCOPE("Allocator::resize");
+        size        = _size;
+        dynamicSize = size - staticSize - frameSize * 2;
+        commit(size + 256);
+        FR_LOG_INFO(ALLOCATOR, "Resized buffer to %zu bytes", size);
+
+        dynamicBlock.resize(dynamicSize);
+        FR_LOG_INFO(ALLOCATOR, "  %zu for dynamic memory", dynamicSize);
     }
     void Allocator::abort() {
-        free(buffer);
-        logWarning(
-            "%sALLOCATOR%s: Abort has been called", FR_LOG_FORMAT_YELLOW, FR_LOG_FORMAT_RESET);
+#ifdef FR_MEMORY_SHADOW
+        unmapShadow(buffer);
+#endif
+        releaseMemory(buffer, reserveSize);
+        FR_LOG_WARNING(ALLOCATOR, "Abort has been called");
+    }
+
+    void Allocator::checkAlignment(usize alignment) {
+        if (isPowerOfTwo(alignment) && alignment <= getPageSize()) return;
+        FR_LOG_ERROR(
+            ALLOCATOR,
+            "Tried to align to %zu, which is not a power of two up to a page",
+            alignment);
+        abort();
+    }
+
+    void Allocator::commit(usize _size) {
+        if (_size <= committed) return;
+        if (_size > reserveSize)
+            FR_LOG_ERROR(
+                ALLOCATOR, "Tried to grow to %zu when only %zu is reserved", _size, reserveSize);
+
+        const usize page = pages == PAGES_DEFAULT ? getPageSize() : HUGE_PAGE_SIZE;
+        _size            = _size + page - 1 & ~(page - 1);
+
+        u8* const   address = (u8*)buffer + committed;
+        const usize length  = _size - committed;
+        if (pages == PAGES_HUGE && !commitHugePages(address, length)) {
+            FR_LOG_WARNING(ALLOCATOR, "Failed to commit %zu bytes of huge pages", length);
+            setPages(PAGES_TRANSPARENT_HUGE);
+        }
+        if (pages != PAGES_HUGE && !commitMemory(address, length))
+            FR_LOG_ERROR(ALLOCATOR, "Failed to commit %zu bytes", length);
+        committed = _size;
+#ifdef FR_MEMORY_SHADOW
+        commitShadow(committed);
+#endif
+    }
+    void Allocator::setPages(AllocatorPages _pages) {
+        if (_pages == PAGES_TRANSPARENT_HUGE
+            && (!hasTransparentHugePages()
+                || !adviseHugePages((u8*)buffer + committed, reserveSize - committed))) {
+            FR_LOG_WARNING(ALLOCATOR, "Transparent huge pages are unavailable");
+            _pages = PAGES_DEFAULT;
+        }
+
+        constexpr const char* PAGE_NAMES[] = {
+            "normal pages",
+            "transparent huge pages",
+            "2 MiB huge pages",
+        };
+        pages = _pages;
+        FR_LOG_INFO(ALLOCATOR, "Backing memory with %s", PAGE_NAMES[pages]);
     }
 
-    u32          Allocator::getID() { return id; }
-    ptr*         Allocator::getBuffer() { return &buffer; }
-    usize        Allocator::getSize() { return size; }
-    StaticBlock* Allocator::getStaticBlock() { return &staticBlock; }
+    u32              Allocator::getID() { return id; }
+    AllocatorPages   Allocator::getPages() { return pages; }
+    ptr*             Allocator::getBuffer() { return &buffer; }
+    usize            Allocator::getSize() { return size; }
+    StaticBlock*     Allocator::getStaticBlock() { return &staticBlock; }
+    FrameBlock*      Allocator::getFrameBlock() { return &frameBlock; }
+    DynamicBlock*    Allocator::getDynamicBlock() { return &dynamicBlock; }
+    PoolBlock*       Allocator::getPoolBlock() { return &poolBlock; }
+    MemoryProfile*   Allocator::getProfile() { return &profile; }
+    RelocationTable* Allocator::getRelocationTable() { return &relocationTable; }
 }
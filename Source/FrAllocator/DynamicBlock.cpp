@@ -1,16 +1,615 @@
+#include <string.h>
+
 #include <FrogEngine/Allocator.h>
+#include <FrogEngine/Atomic.h>
+#include <FrogEngine/Log.h>
+#include <FrogEngine/Runtime.h>
+#include <FrogEngine/Shadow.h>
 #include <FrogEngine/Utility.h>
 
 namespace FrogEngine {
+    constexpr usize DYNAMIC_FLAGS { DYNAMIC_ALIGN - 1 };
+    constexpr usize DYNAMIC_FREE { 1 };
+    constexpr usize DYNAMIC_MOVABLE { 2 };
+    constexpr u32   DYNAMIC_TAG_SHIFT { 56 };
+    constexpr usize DYNAMIC_META { DYNAMIC_FLAGS | (usize)0xFF << DYNAMIC_TAG_SHIFT };
+    constexpr usize DYNAMIC_NONE { ~(usize)0 };
+    constexpr usize DYNAMIC_HEADER { 16 };
+    constexpr usize DYNAMIC_MIN_PAYLOAD { 16 };
+    constexpr u32   DYNAMIC_SECOND_LOG2 { 4 };
+    constexpr u32   DYNAMIC_FIRST_SHIFT { DYNAMIC_SECOND_LOG2 + 4 };
+    constexpr usize DYNAMIC_SMALL { (usize)1 << DYNAMIC_FIRST_SHIFT };
+    // Movable blocks keep their relocation table index and requested size in front of the
+    // payload.
+    constexpr usize DYNAMIC_MOVABLE_PREFIX { 16 };
+    // Blocks compact() walks between two looks at the clock.
+    constexpr u32 DYNAMIC_COMPACT_STEPS { 64 };
+
+    // Every block starts with a header. `previous` is the offset of the physically previous
+    // block and `size` is the payload size with DYNAMIC_FREE and DYNAMIC_MOVABLE packed into the
+    // low bits and the AllocTag of used blocks packed into the top byte.
+    struct DynamicHeader {
+        usize previous;
+        usize size;
+    };
+    // Free blocks store their free list links in the first bytes of the payload.
+    struct DynamicLinks {
+        usize next;
+        usize previous;
+    };
+
+    inline DynamicHeader* getHeader(ptr buffer, usize block) {
+        return (DynamicHeader*)((u8*)buffer + block);
+    }
+    inline DynamicLinks* getLinks(ptr buffer, usize block) {
+        return (DynamicLinks*)((u8*)buffer + block + DYNAMIC_HEADER);
+    }
+    inline usize getBlockSize(ptr buffer, usize block) {
+        return getHeader(buffer, block)->size & ~DYNAMIC_META;
+    }
+    inline AllocTag getBlockTag(ptr buffer, usize block) {
+        return (AllocTag)(getHeader(buffer, block)->size >> DYNAMIC_TAG_SHIFT);
+    }
+    inline bool isBlockFree(ptr buffer, usize block) {
+        return getHeader(buffer, block)->size & DYNAMIC_FREE;
+    }
+    inline bool isBlockMovable(ptr buffer, usize block) {
+        return getHeader(buffer, block)->size & DYNAMIC_MOVABLE;
+    }
+    inline u32* getMovablePrefix(ptr buffer, usize block) {
+        return (u32*)((u8*)buffer + block + DYNAMIC_HEADER);
+    }
+    inline usize* getMovableSize(ptr buffer, usize block) {
+        return (usize*)((u8*)buffer + block + DYNAMIC_HEADER + sizeof(usize));
+    }
+    inline usize getNextBlock(ptr buffer, usize block) {
+        return block + DYNAMIC_HEADER + getBlockSize(buffer, block);
+    }
+
+    // Shadow state of blocks. Headers are redzones the allocator still reads, free blocks keep
+    // their links readable and used blocks expose exactly the requested bytes. A block has to be
+    // opened before the allocator writes anywhere inside it.
+    inline void openBlock(ptr buffer, usize block) {
+#ifdef FR_MEMORY_POISON
+        unpoisonMemory(getHeader(buffer, block), DYNAMIC_HEADER + getBlockSize(buffer, block));
+#endif
+    }
+    inline void markFree(ptr buffer, usize block) {
+#ifdef FR_MEMORY_POISON
+        poisonMemory(getHeader(buffer, block), DYNAMIC_HEADER, SHADOW_REDZONE, DYNAMIC_HEADER);
+        poisonMemory(
+            getLinks(buffer, block),
+            getBlockSize(buffer, block),
+            SHADOW_FREED,
+            sizeof(DynamicLinks));
+#endif
+    }
+    inline void markUsed(ptr buffer, usize block, usize begin, usize end) {
+#ifdef FR_MEMORY_POISON
+        u8* const   payload  = (u8*)buffer + block + DYNAMIC_HEADER;
+        const usize metadata = DYNAMIC_HEADER + begin;
+        poisonMemory(getHeader(buffer, block), metadata, SHADOW_REDZONE, metadata);
+        unpoisonMemory(payload + begin, end - begin);
+        poisonMemory(payload + end, getBlockSize(buffer, block) - end, SHADOW_REDZONE);
+#endif
+    }
+
+    inline u32   findLastSet(usize value) { return 63 - __builtin_clzll((u64)value); }
+    inline usize adjustSize(usize _size) {
+        _size = _size + DYNAMIC_FLAGS & ~DYNAMIC_FLAGS;
+        return _size < DYNAMIC_MIN_PAYLOAD ? DYNAMIC_MIN_PAYLOAD : _size;
+    }
+    inline void mapSize(usize _size, u32* first, u32* second) {
+        if (_size < DYNAMIC_SMALL) {
+            *first  = 0;
+            *second = (u32)(_size / (DYNAMIC_SMALL / DYNAMIC_SECOND_COUNT));
+            return;
+        }
+        const u32 bit = findLastSet(_size);
+        *second       = (u32)(_size >> (bit - DYNAMIC_SECOND_LOG2)) ^ DYNAMIC_SECOND_COUNT;
+        *first        = bit - (DYNAMIC_FIRST_SHIFT - 1);
+    }
+
     DynamicBlock::DynamicBlock(Allocator* _allocator) : allocator(_allocator) {}
     DynamicBlock::~DynamicBlock() {}
 
     void DynamicBlock::init(ptr _buffer, usize _size) {
         buffer = _buffer;
-        size   = _size;
+        size   = _size & ~DYNAMIC_FLAGS;
+        used   = 0;
+
+        compactCursor = 0;
+
+        firstMap = 0;
+        memset(secondMap, 0, sizeof(secondMap));
+        for (u32 first = 0; first < DYNAMIC_FIRST_COUNT; first++)
+            for (u32 second = 0; second < DYNAMIC_SECOND_COUNT; second++)
+                freeLists[first][second] = DYNAMIC_NONE;
+
+        if (size < DYNAMIC_HEADER * 2 + DYNAMIC_MIN_PAYLOAD) {
+            size = 0;
+            return;
+        }
+
+        // One free block spanning the region, followed by a zero sized used sentinel so merging
+        // never has to check for the end of the region.
+        unpoisonMemory(buffer, size);
+        DynamicHeader* first = getHeader(buffer, 0);
+        first->previous      = DYNAMIC_NONE;
+        first->size          = size - DYNAMIC_HEADER * 2 | DYNAMIC_FREE;
+
+        DynamicHeader* sentinel = getHeader(buffer, size - DYNAMIC_HEADER);
+        sentinel->previous      = 0;
+        sentinel->size          = 0;
+
+        insertFree(0);
+        markFree(buffer, 0);
+        poisonMemory(sentinel, DYNAMIC_HEADER, SHADOW_REDZONE, DYNAMIC_HEADER);
+    }
+    void DynamicBlock::resize(usize _size) {
+        _size &= ~DYNAMIC_FLAGS;
+        if (size == 0) {
+            init(buffer, _size);
+            return;
+        }
+        if (_size < size + DYNAMIC_HEADER + DYNAMIC_MIN_PAYLOAD) return;
+
+        // The old sentinel becomes the header of the new free space. A compaction cursor left on
+        // it stays valid, or follows it into the merge below.
+        const usize block = size - DYNAMIC_HEADER;
+        unpoisonMemory(getHeader(buffer, block), _size - block);
+
+        DynamicHeader* header = getHeader(buffer, block);
+        header->size          = _size - size - DYNAMIC_HEADER | DYNAMIC_FREE;
+
+        DynamicHeader* sentinel = getHeader(buffer, _size - DYNAMIC_HEADER);
+        sentinel->previous      = block;
+        sentinel->size          = 0;
+
+        size = _size;
+
+        const usize merged = mergeBlock(block);
+        insertFree(merged);
+        markFree(buffer, merged);
+        poisonMemory(sentinel, DYNAMIC_HEADER, SHADOW_REDZONE, DYNAMIC_HEADER);
+    }
+    Pointer<u8> DynamicBlock::alloc(usize _size, AllocTag tag) {
+        return allocAligned(_size, DYNAMIC_ALIGN, tag);
+    }
+    Pointer<u8> DynamicBlock::allocAligned(usize _size, usize alignment, AllocTag tag) {
+        allocator->checkAlignment(alignment);
+        SpinGuard guard(&lock);
+
+        const usize block = allocBlock(_size, tag, alignment);
+        return Pointer<u8>(
+            block + DYNAMIC_HEADER, (uptr*)&buffer, _size, allocator->getBuffer(), 0);
+    }
+    Pointer<u8> DynamicBlock::realloc(
+        Pointer<u8> pointer, usize _old, usize _new, usize alignment) {
+        SpinGuard guard(&lock);
+
+        const usize block    = pointer.getOffset() - DYNAMIC_HEADER;
+        const usize adjusted = adjustSize(_new);
+        const usize current  = getBlockSize(buffer, block);
+
+        if (adjusted <= current) {
+            openBlock(buffer, block);
+            splitBlock(block, adjusted);
+            markUsed(buffer, block, 0, _new);
+            used -= current - getBlockSize(buffer, block);
+#if defined(FR_DEBUG) || defined(FR_MEMORY_PROFILE)
+            allocator->getProfile()->onResize(
+                getBlockTag(buffer, block), current, getBlockSize(buffer, block));
+#endif
+            return Pointer<u8>(
+                block + DYNAMIC_HEADER, (uptr*)&buffer, _new, allocator->getBuffer(), 0);
+        }
+
+        // Grow in place by absorbing the next block when it is free and large enough.
+        const usize next = getNextBlock(buffer, block);
+        if (isBlockFree(buffer, next)
+            && current + DYNAMIC_HEADER + getBlockSize(buffer, next) >= adjusted) {
+            removeFree(next);
+            getHeader(buffer, block)->size += DYNAMIC_HEADER + getBlockSize(buffer, next);
+            if (compactCursor == next) compactCursor = block;
+            openBlock(buffer, block);
+            getHeader(buffer, getNextBlock(buffer, block))->previous = block;
+            splitBlock(block, adjusted);
+            markUsed(buffer, block, 0, _new);
+            used += getBlockSize(buffer, block) - current;
+            trackPeak(block);
+#if defined(FR_DEBUG) || defined(FR_MEMORY_PROFILE)
+            allocator->getProfile()->onResize(
+                getBlockTag(buffer, block), current, getBlockSize(buffer, block));
+#endif
+            return Pointer<u8>(
+                block + DYNAMIC_HEADER, (uptr*)&buffer, _new, allocator->getBuffer(), 0);
+        }
+
+        const usize moved = allocBlock(_new, getBlockTag(buffer, block), alignment);
+        memcpy(
+            (u8*)buffer + moved + DYNAMIC_HEADER,
+            (u8*)buffer + block + DYNAMIC_HEADER,
+            _old < current ? _old : current);
+        freeBlock(block);
+        return Pointer<u8>(
+            moved + DYNAMIC_HEADER, (uptr*)&buffer, _new, allocator->getBuffer(), 0);
+    }
+    void DynamicBlock::dealloc(Pointer<u8> pointer, usize _size) {
+        SpinGuard guard(&lock);
+
+        const usize block = pointer.getOffset() - DYNAMIC_HEADER;
+#ifdef FR_DEBUG
+        if ((uptr)pointer.get() - pointer.getOffset() != (uptr)buffer || block >= size
+            || isBlockFree(buffer, block)) {
+            FR_LOG_ERROR(
+                ALLOCATOR, "Tried to dealloc %zu bytes not owned by dynamic memory", _size);
+            allocator->abort();
+        }
+#endif
+        freeBlock(block);
+    }
+
+#ifndef FR_STABLE_POINTER
+    Pointer<u8> DynamicBlock::allocMovable(usize _size, AllocTag tag) {
+        SpinGuard guard(&lock);
+
+        const usize block = allocBlock(_size + DYNAMIC_MOVABLE_PREFIX, tag, DYNAMIC_ALIGN);
+        getHeader(buffer, block)->size |= DYNAMIC_MOVABLE;
+
+        RelocationTable* table = allocator->getRelocationTable();
+        const u32        index =
+            table->acquire((uptr)buffer + block + DYNAMIC_HEADER + DYNAMIC_MOVABLE_PREFIX);
+        *getMovablePrefix(buffer, block) = index;
+        *getMovableSize(buffer, block)   = _size;
+        markUsed(buffer, block, DYNAMIC_MOVABLE_PREFIX, DYNAMIC_MOVABLE_PREFIX + _size);
+        return Pointer<u8>(0, &table->getEntry(index)->address, _size, allocator->getBuffer(), 0);
+    }
+    void DynamicBlock::deallocMovable(Pointer<u8> pointer) {
+        SpinGuard guard(&lock);
+
+        const u32   index = getMovableIndex(pointer);
+        const usize block = *pointer.getBase() - (uptr)buffer - DYNAMIC_MOVABLE_PREFIX
+                          - DYNAMIC_HEADER;
+        freeBlock(block);
+        allocator->getRelocationTable()->release(index);
+    }
+    void DynamicBlock::pin(Pointer<u8> pointer) {
+        SpinGuard guard(&lock);
+        allocator->getRelocationTable()->getEntry(getMovableIndex(pointer))->pins++;
+    }
+    void DynamicBlock::unpin(Pointer<u8> pointer) {
+        SpinGuard guard(&lock);
+
+        RelocationTable* table = allocator->getRelocationTable();
+        RelocationEntry* entry = table->getEntry(getMovableIndex(pointer));
+        if (!entry->pins)
+            FR_LOG_ERROR(ALLOCATOR, "Tried to unpin movable memory that is not pinned");
+        entry->pins--;
+    }
+
+    Handle<u8> DynamicBlock::getHandle(Pointer<u8> pointer) {
+        SpinGuard guard(&lock);
+        return allocator->getRelocationTable()->getHandle<u8>(getMovableIndex(pointer));
+    }
+
+    CompactStats DynamicBlock::compact(u64 budget) {
+        const u64 deadline = getTime() + budget;
+        SpinGuard guard(&lock);
+
+        compactStats.bytesMoved  = 0;
+        compactStats.blocksMoved = 0;
+        if (!size) return compactStats;
+
+        // Sliding a block down moves its hole up, where it merges with the next hole. Repeating
+        // this gathers free space at the end of the region. The walk goes on from where the last
+        // call ran out of time and starts over at the front once it reaches the end.
+        RelocationTable* table = allocator->getRelocationTable();
+        usize            block = compactCursor;
+        for (u32 step = 1; block < size - DYNAMIC_HEADER; step++) {
+            if (step % DYNAMIC_COMPACT_STEPS == 0 && getTime() >= deadline) break;
+
+            const usize next = getNextBlock(buffer, block);
+            if (!isBlockFree(buffer, block) || !isBlockMovable(buffer, next)
+                || table->getEntry(*getMovablePrefix(buffer, next))->pins) {
+                block = next;
+                continue;
+            }
+            if (getTime() >= deadline) break;
+
+            compactStats.bytesMoved += getBlockSize(buffer, next);
+            compactStats.blocksMoved++;
+            block = slideBlock(block);
+        }
+        compactCursor = block < size - DYNAMIC_HEADER ? block : 0;
+
+        compactStats.totalBytesMoved  += compactStats.bytesMoved;
+        compactStats.totalBlocksMoved += compactStats.blocksMoved;
+        return compactStats;
+    }
+    CompactStats DynamicBlock::getCompactStats() const { return compactStats; }
+#endif
+
+    void DynamicBlock::setBuffer(ptr _buffer) { buffer = _buffer; }
+
+    const ptr DynamicBlock::getBuffer() const { return buffer; }
+    uptr*     DynamicBlock::getBase() { return (uptr*)&buffer; }
+    usize     DynamicBlock::getSize() const { return size; }
+    usize     DynamicBlock::getUsed() const { return used; }
+    usize     DynamicBlock::getPeak() const { return peak; }
+
+    DynamicStats DynamicBlock::getStats() {
+        SpinGuard guard(&lock);
+
+        DynamicStats stats {};
+        stats.size = size;
+        stats.used = used;
+        if (!size) return stats;
+
+        for (usize block = 0; block < size - DYNAMIC_HEADER; block = getNextBlock(buffer, block)) {
+            stats.blocks++;
+            if (!isBlockFree(buffer, block)) continue;
+
+            const usize block_size = getBlockSize(buffer, block);
+            stats.free            += block_size;
+            stats.freeBlocks++;
+            if (block_size > stats.largestFree) stats.largestFree = block_size;
+        }
+        if (stats.free) stats.fragmentation = 1.0f - (f32)stats.largestFree / (f32)stats.free;
+        return stats;
+    }
+    void DynamicBlock::logStats() {
+        const DynamicStats stats = getStats();
+        FR_LOG_INFO(ALLOCATOR, "Dynamic memory occupancy");
+        FR_LOG_INFO(
+            ALLOCATOR,
+            "  %zu out of %zu bytes in %zu blocks",
+            stats.used,
+            stats.size,
+            stats.blocks);
+        FR_LOG_INFO(
+            ALLOCATOR,
+            "  %zu bytes free in %zu blocks, largest %zu",
+            stats.free,
+            stats.freeBlocks,
+            stats.largestFree);
+        FR_LOG_INFO(ALLOCATOR, "  %.1f%% fragmentation", stats.fragmentation * 100.0f);
+    }
+    void DynamicBlock::walk(DynamicVisitor visit, ptr user) {
+        SpinGuard guard(&lock);
+        if (!size) return;
+
+        for (usize block = 0; block < size - DYNAMIC_HEADER; block = getNextBlock(buffer, block))
+            visit(
+                user,
+                block,
+                getBlockSize(buffer, block),
+                getBlockTag(buffer, block),
+                isBlockFree(buffer, block));
+    }
+
+    usize DynamicBlock::allocBlock(usize _size, AllocTag tag, usize alignment) {
+        const usize adjusted = adjustSize(_size);
+
+        // Aligned requests need room to split off a leading free block of at least the minimum
+        // size in front of the aligned payload.
+        const usize search = alignment > DYNAMIC_ALIGN
+                               ? adjusted + alignment + DYNAMIC_HEADER + DYNAMIC_MIN_PAYLOAD
+                               : adjusted;
+
+        usize block = findFree(search);
+        if (block == DYNAMIC_NONE) {
+            grow(search);
+            block = findFree(search);
+            if (block == DYNAMIC_NONE) {
+                FR_LOG_ERROR(ALLOCATOR, "Failed to alloc %zu bytes of dynamic memory", _size);
+                allocator->abort();
+            }
+        }
+
+        removeFree(block);
+        openBlock(buffer, block);
+        if (alignment > DYNAMIC_ALIGN) block = alignBlock(block, alignment);
+
+        DynamicHeader* header  = getHeader(buffer, block);
+        header->size          &= ~DYNAMIC_FREE;
+        header->size          |= (usize)tag << DYNAMIC_TAG_SHIFT;
+        splitBlock(block, adjusted);
+        markUsed(buffer, block, 0, _size);
+        used += getBlockSize(buffer, block);
+        trackPeak(block);
+#if defined(FR_DEBUG) || defined(FR_MEMORY_PROFILE)
+        allocator->getProfile()->onAlloc(tag, getBlockSize(buffer, block));
+#endif
+        return block;
+    }
+    usize DynamicBlock::alignBlock(usize block, usize alignment) {
+        const uptr payload = (uptr)buffer + block + DYNAMIC_HEADER;
+        usize      gap     = (payload + alignment - 1 & ~(alignment - 1)) - payload;
+        if (!gap) return block;
+        if (gap < DYNAMIC_HEADER + DYNAMIC_MIN_PAYLOAD) gap += alignment;
+
+        // The front of the block is returned as a free block and the rest is still unlinked,
+        // so it is not merged back.
+        const usize    total   = getBlockSize(buffer, block);
+        const usize    aligned = block + gap;
+        DynamicHeader* header  = getHeader(buffer, aligned);
+        header->previous       = block;
+        header->size           = total - gap;
+        getHeader(buffer, getNextBlock(buffer, aligned))->previous = aligned;
+
+        getHeader(buffer, block)->size = gap - DYNAMIC_HEADER | DYNAMIC_FREE;
+        insertFree(block);
+        markFree(buffer, block);
+        return aligned;
+    }
+    void DynamicBlock::freeBlock(usize block) {
+        const usize block_size = getBlockSize(buffer, block);
+#if defined(FR_DEBUG) || defined(FR_MEMORY_PROFILE)
+        allocator->getProfile()->onFree(getBlockTag(buffer, block), block_size);
+#endif
+#ifdef FR_MEMORY_POISON
+        openBlock(buffer, block);
+        memset(getLinks(buffer, block), SHADOW_FREED_PATTERN, block_size);
+#endif
+        used                         -= block_size;
+        getHeader(buffer, block)->size = block_size | DYNAMIC_FREE;
+
+        const usize merged = mergeBlock(block);
+        insertFree(merged);
+        markFree(buffer, merged);
+    }
+
+    void DynamicBlock::trackPeak(usize block) {
+        // The region has to reach past the block's end and the sentinel to avoid growing.
+        const usize end = getNextBlock(buffer, block) + DYNAMIC_HEADER;
+        if (end > peak) peak = end;
+    }
+    void DynamicBlock::insertFree(usize block) {
+        u32 first, second;
+        mapSize(getBlockSize(buffer, block), &first, &second);
+
+        const usize   head  = freeLists[first][second];
+        DynamicLinks* links = getLinks(buffer, block);
+        links->next         = head;
+        links->previous     = DYNAMIC_NONE;
+        if (head != DYNAMIC_NONE) getLinks(buffer, head)->previous = block;
+
+        freeLists[first][second]  = block;
+        firstMap                 |= 1u << first;
+        secondMap[first]         |= 1u << second;
+    }
+    void DynamicBlock::removeFree(usize block) {
+        u32 first, second;
+        mapSize(getBlockSize(buffer, block), &first, &second);
+
+        const DynamicLinks* links = getLinks(buffer, block);
+        if (links->next != DYNAMIC_NONE) getLinks(buffer, links->next)->previous = links->previous;
+        if (links->previous != DYNAMIC_NONE) {
+            getLinks(buffer, links->previous)->next = links->next;
+            return;
+        }
+
+        freeLists[first][second] = links->next;
+        if (links->next != DYNAMIC_NONE) return;
+        secondMap[first] &= ~(1u << second);
+        if (!secondMap[first]) firstMap &= ~(1u << first);
+    }
+    usize DynamicBlock::findFree(usize _size) const {
+        // Round up to the next list so any block found there is large enough.
+        if (_size >= DYNAMIC_SMALL)
+            _size += ((usize)1 << (findLastSet(_size) - DYNAMIC_SECOND_LOG2)) - 1;
+
+        u32 first, second;
+        mapSize(_size, &first, &second);
+        if (first >= DYNAMIC_FIRST_COUNT) return DYNAMIC_NONE;
+
+        u32 second_map = secondMap[first] & (~0u << second);
+        if (!second_map) {
+            const u32 first_map = firstMap & (u32)(~0ull << (first + 1));
+            if (!first_map) return DYNAMIC_NONE;
+
+            first      = __builtin_ctz(first_map);
+            second_map = secondMap[first];
+        }
+        return freeLists[first][__builtin_ctz(second_map)];
+    }
+    void DynamicBlock::splitBlock(usize block, usize _size) {
+        const usize total = getBlockSize(buffer, block);
+        if (total < _size + DYNAMIC_HEADER + DYNAMIC_MIN_PAYLOAD) return;
+
+        DynamicHeader* header = getHeader(buffer, block);
+        header->size          = _size | (header->size & DYNAMIC_META);
+
+        const usize    rest      = block + DYNAMIC_HEADER + _size;
+        DynamicHeader* remainder = getHeader(buffer, rest);
+        remainder->previous      = block;
+        remainder->size          = total - _size - DYNAMIC_HEADER | DYNAMIC_FREE;
+        getHeader(buffer, getNextBlock(buffer, rest))->previous = rest;
+
+        const usize merged = mergeBlock(rest);
+        insertFree(merged);
+        markFree(buffer, merged);
+    }
+    // A swallowed block takes the compaction cursor with it into the block that swallowed it.
+    usize DynamicBlock::mergeBlock(usize block) {
+        const usize next = getNextBlock(buffer, block);
+        if (isBlockFree(buffer, next)) {
+            removeFree(next);
+            getHeader(buffer, block)->size += DYNAMIC_HEADER + getBlockSize(buffer, next);
+            getHeader(buffer, getNextBlock(buffer, block))->previous = block;
+            if (compactCursor == next) compactCursor = block;
+        }
+
+        const usize previous = getHeader(buffer, block)->previous;
+        if (previous != DYNAMIC_NONE && isBlockFree(buffer, previous)) {
+            removeFree(previous);
+            getHeader(buffer, previous)->size += DYNAMIC_HEADER + getBlockSize(buffer, block);
+            getHeader(buffer, getNextBlock(buffer, previous))->previous = previous;
+            if (compactCursor == block) compactCursor = previous;
+            block = previous;
+        }
+        return block;
+    }
+    usize DynamicBlock::slideBlock(usize block) {
+        const usize moved      = getNextBlock(buffer, block);
+        const usize moved_size = getBlockSize(buffer, moved);
+        const usize free_size  = getBlockSize(buffer, block);
+        const usize meta       = getHeader(buffer, moved)->size & DYNAMIC_META;
+        removeFree(block);
+        openBlock(buffer, block);
+        openBlock(buffer, moved);
+
+        // The payload may overlap its old header, so read everything before moving it.
+        memmove(
+            (u8*)buffer + block + DYNAMIC_HEADER,
+            (u8*)buffer + moved + DYNAMIC_HEADER,
+            moved_size);
+        getHeader(buffer, block)->size = moved_size | meta;
+        if (compactCursor == moved) compactCursor = block;
+
+        const usize    rest      = block + DYNAMIC_HEADER + moved_size;
+        DynamicHeader* remainder = getHeader(buffer, rest);
+        remainder->previous      = block;
+        remainder->size          = free_size | DYNAMIC_FREE;
+        getHeader(buffer, getNextBlock(buffer, rest))->previous = rest;
+
+        RelocationEntry* entry = allocator->getRelocationTable()->getEntry(
+            *getMovablePrefix(buffer, block));
+        entry->address = (uptr)buffer + block + DYNAMIC_HEADER + DYNAMIC_MOVABLE_PREFIX;
+
+        const usize merged = mergeBlock(rest);
+        insertFree(merged);
+        markFree(buffer, merged);
+        markUsed(
+            buffer,
+            block,
+            DYNAMIC_MOVABLE_PREFIX,
+            DYNAMIC_MOVABLE_PREFIX + *getMovableSize(buffer, block));
+        return merged;
+    }
+#ifndef FR_STABLE_POINTER
+    u32 DynamicBlock::getMovableIndex(Pointer<u8> pointer) {
+        RelocationTable* table = allocator->getRelocationTable();
+        const u32        index = table->getIndex((RelocationEntry*)pointer.getBase());
+#ifdef FR_DEBUG
+        const usize block = *pointer.getBase() - (uptr)buffer - DYNAMIC_MOVABLE_PREFIX
+                          - DYNAMIC_HEADER;
+        if (index >= table->getCount() || block >= size || isBlockFree(buffer, block)
+            || !isBlockMovable(buffer, block) || *getMovablePrefix(buffer, block) != index) {
+            FR_LOG_ERROR(ALLOCATOR, "Pointer does not refer to movable dynamic memory");
+            allocator->abort();
+        }
+#endif
+        return index;
+    }
+#endif
+    void DynamicBlock::grow(usize _size) {
+        usize grow_size = _size + DYNAMIC_HEADER * 2;
+        if (_size >= DYNAMIC_SMALL) grow_size += (usize)1 << (findLastSet(_size) - DYNAMIC_SECOND_LOG2);
+        if (grow_size < size) grow_size = size;
+
+        FR_LOG_INFO(ALLOCATOR, "Growing dynamic memory by %zu bytes", grow_size);
+        allocator->resize(allocator->getSize() + grow_size);
     }
-    void        DynamicBlock::resize(usize _size) {}
-    Pointer<u8> alloc(usize _size) {}
-    Pointer<u8> realloc(Pointer<u8> pointer, usize _old, usize _new) {}
-    void        dealloc(Pointer<u8> pointer, usize _size) {}
 }
@@ -0,0 +1,52 @@
+#include <FrogEngine/Allocator.h>
+#include <FrogEngine/Log.h>
+#include <FrogEngine/Pointer.h>
+#include <FrogEngine/Shadow.h>
+#include <FrogEngine/Utility.h>
+
+namespace FrogEngine {
+    FrameBlock::FrameBlock(Allocator* _allocator) : allocator(_allocator) {}
+    FrameBlock::~FrameBlock() {}
+
+    void FrameBlock::init(ptr _buffer, usize _size) {
+        buffer = _buffer;
+        size   = _size & ~(CACHE_LINE_SIZE - 1);
+        start  = 0;
+        index  = 0;
+        poisonMemory(buffer, size * 2, SHADOW_UNALLOCATED);
+    }
+    Pointer<u8> FrameBlock::alloc(usize _size) { return allocAligned(_size, 16); }
+    Pointer<u8> FrameBlock::allocAligned(usize _size, usize alignment) {
+        allocator->checkAlignment(alignment);
+        const uptr offset = alignUp((uptr)buffer + index, alignment) - (uptr)buffer;
+        const uptr end    = offset + _size;
+        if (end - start > peak) peak = end - start;
+        if (end - start > size) {
+            FR_LOG_ERROR(
+                ALLOCATOR,
+                "Tried to alloc %zu when only %zu is allocated for a frame",
+                end - start,
+                size);
+            allocator->abort();
+        }
+
+        index = end;
+        unpoisonMemory((u8*)buffer + offset, _size);
+        return Pointer<u8>(offset, (uptr*)&buffer, _size, allocator->getBuffer(), 0);
+    }
+    void FrameBlock::swap() {
+        start = start ? 0 : size;
+        index = start;
+        poisonMemory((u8*)buffer + start, size, SHADOW_FREED);
+#ifndef FR_STABLE_POINTER
+        // Frames are where long sessions fragment dynamic memory, so they also undo it a little.
+        allocator->getDynamicBlock()->compact(DYNAMIC_COMPACT_BUDGET);
+#endif
+    }
+
+    void FrameBlock::setBuffer(ptr _buffer) { buffer = _buffer; }
+
+    const ptr FrameBlock::getBuffer() const { return buffer; }
+    usize     FrameBlock::getSize() const { return size; }
+    usize     FrameBlock::getPeak() const { return peak; }
+}
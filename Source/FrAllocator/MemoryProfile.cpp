@@ -0,0 +1,160 @@
+#include <FrogEngine/Allocator.h>
+#include <FrogEngine/Log.h>
+#include <FrogEngine/Runtime.h>
+#include <FrogEngine/Utility.h>
+
+namespace FrogEngine {
+    // Heap map files start with a HeapMapHeader, followed by `tagCount` HeapMapTags and
+    // `blockCount` HeapMapBlocks in address order. All fields are little endian.
+    constexpr u32 HEAP_MAP_MAGIC { 0x4D'48'52'46 }; // "FRHM"
+    constexpr u32 HEAP_MAP_VERSION { 1 };
+
+    struct HeapMapHeader {
+        u32 magic;
+        u32 version;
+        u32 tagCount;
+        u32 blockCount;
+        u64 staticSize;
+        u64 staticUsed;
+        u64 frameSize;
+        u64 framePeak;
+        u64 dynamicSize;
+        u64 dynamicUsed;
+    };
+    struct HeapMapTag {
+        u64 live;
+        u64 peak;
+        u64 calls;
+    };
+    struct HeapMapBlock {
+        u64 offset;
+        u64 size;
+        u8  tag;
+        u8  free;
+        u8  padding[6];
+    };
+
+    struct HeapMapWriter {
+        FileHandle file;
+        u32        blocks;
+        bool       failed;
+    };
+
+    static void writeHeapMapBlock(ptr user, usize offset, usize _size, AllocTag tag, bool free) {
+        HeapMapWriter* writer = (HeapMapWriter*)user;
+        HeapMapBlock   block { offset, _size, tag, free, {} };
+        if (writeFile(writer->file, &block, sizeof(HeapMapBlock)) != sizeof(HeapMapBlock))
+            writer->failed = true;
+        writer->blocks++;
+    }
+
+    void MemoryProfile::onAlloc(AllocTag tag, usize _size) {
+        TagStats &stats = tags[tag];
+        __atomic_add_fetch(&stats.calls, 1, __ATOMIC_RELAXED);
+        onResize(tag, 0, _size);
+    }
+    void MemoryProfile::onResize(AllocTag tag, usize _old, usize _new) {
+        TagStats   &stats = tags[tag];
+        const usize live  = __atomic_add_fetch(&stats.live, _new - _old, __ATOMIC_RELAXED);
+
+        usize peak = __atomic_load_n(&stats.peak, __ATOMIC_RELAXED);
+        while (live > peak
+               && !__atomic_compare_exchange_n(
+                   &stats.peak, &peak, live, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {}
+    }
+    void MemoryProfile::onFree(AllocTag tag, usize _size) {
+        __atomic_sub_fetch(&tags[tag].live, _size, __ATOMIC_RELAXED);
+    }
+
+    TagStats MemoryProfile::getStats(AllocTag tag) const {
+        TagStats stats {};
+        stats.live  = __atomic_load_n(&tags[tag].live, __ATOMIC_RELAXED);
+        stats.peak  = __atomic_load_n(&tags[tag].peak, __ATOMIC_RELAXED);
+        stats.calls = __atomic_load_n(&tags[tag].calls, __ATOMIC_RELAXED);
+        return stats;
+    }
+    void MemoryProfile::logStats() const {
+#if defined(FR_DEBUG) || defined(FR_MEMORY_PROFILE)
+        FR_LOG_INFO(ALLOCATOR, "Memory by tag");
+        for (u32 tag = 0; tag < ALLOC_TAG_COUNT; tag++) {
+            const TagStats stats = getStats((AllocTag)tag);
+            if (!stats.calls) continue;
+            FR_LOG_INFO(
+                ALLOCATOR,
+                "  %-8s %zu bytes live, %zu peak in %zu calls",
+                getTagName((AllocTag)tag),
+                stats.live,
+                stats.peak,
+                stats.calls);
+        }
+#else
+        FR_LOG_WARNING(ALLOCATOR, "Memory profiling is disabled, define FR_MEMORY_PROFILE");
+#endif
+    }
+
+    const char* getTagName(AllocTag tag) {
+        constexpr const char* TAG_NAMES[] = {
+            "GENERAL",
+            "POOL",
+            "WINDOW",
+            "SAVE",
+            "STRING",
+            "ENTITY",
+            "JOB",
+        };
+        constexpr const char* USER_NAMES[] = {
+            "USER0", "USER1", "USER2", "USER3", "USER4", "USER5",
+            "USER6", "USER7", "USER8",
+        };
+        static_assert(
+            sizeof(USER_NAMES) / sizeof(*USER_NAMES) == ALLOC_TAG_COUNT - TAG_USER,
+            "Every tag needs a name");
+
+        if (tag < TAG_USER) return TAG_NAMES[tag];
+        if (tag < ALLOC_TAG_COUNT) return USER_NAMES[tag - TAG_USER];
+        return "UNKNOWN";
+    }
+
+    bool Allocator::dumpHeap(const char* path) {
+        const FileHandle file = openFile(path, FILE_WRITE);
+        if (file == FILE_NONE) {
+            FR_LOG_WARNING(ALLOCATOR, "Failed to open %s for the heap map", path);
+            return false;
+        }
+
+        HeapMapHeader header {};
+        header.magic       = HEAP_MAP_MAGIC;
+        header.version     = HEAP_MAP_VERSION;
+        header.tagCount    = ALLOC_TAG_COUNT;
+        header.staticSize  = staticBlock.getSize();
+        header.staticUsed  = staticBlock.getMarker();
+        header.frameSize   = frameBlock.getSize();
+        header.framePeak   = frameBlock.getPeak();
+        header.dynamicSize = dynamicBlock.getSize();
+        header.dynamicUsed = dynamicBlock.getUsed();
+
+        HeapMapWriter writer { file, 0, false };
+        writer.failed = writeFile(file, &header, sizeof(HeapMapHeader)) != sizeof(HeapMapHeader);
+        for (u32 tag = 0; tag < ALLOC_TAG_COUNT; tag++) {
+            const TagStats stats = profile.getStats((AllocTag)tag);
+            HeapMapTag     entry { stats.live, stats.peak, stats.calls };
+            if (writeFile(file, &entry, sizeof(HeapMapTag)) != sizeof(HeapMapTag))
+                writer.failed = true;
+        }
+        dynamicBlock.walk(writeHeapMapBlock, &writer);
+
+        // The block count is only known after the walk.
+        header.blockCount = writer.blocks;
+        if (!seekFile(file, 0)
+            || writeFile(file, &header, sizeof(HeapMapHeader)) != sizeof(HeapMapHeader))
+            writer.failed = true;
+        if (!closeFile(file)) writer.failed = true;
+
+        if (writer.failed) {
+            FR_LOG_WARNING(ALLOCATOR, "Failed to write the heap map to %s", path);
+            return false;
+        }
+        FR_LOG_INFO(ALLOCATOR, "Wrote heap map with %u blocks to %s", writer.blocks, path);
+        return true;
+    }
+}
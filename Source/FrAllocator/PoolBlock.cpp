@@ -0,0 +1,161 @@
+#include <FrogEngine/Allocator.h>
+#include <FrogEngine/Atomic.h>
+#include <FrogEngine/Log.h>
+#include <FrogEngine/Shadow.h>
+#include <FrogEngine/Utility.h>
+
+namespace FrogEngine {
+    constexpr usize POOL_NONE { ~(usize)0 };
+
+    PoolBlock::PoolBlock(Allocator* _allocator) :
+        allocator(_allocator),
+        base(_allocator->getDynamicBlock()->getBase()),
+        allocatorBuffer(_allocator->getBuffer()) {
+        for (u32 pool_class = 0; pool_class < POOL_CLASS_COUNT; pool_class++)
+            classes[pool_class].freeList = POOL_NONE;
+        chunks.freeList = POOL_NONE;
+    }
+    PoolBlock::~PoolBlock() {}
+
+    PoolStats PoolBlock::getStats(u32 pool_class) const {
+        const PoolClass &current   = classes[pool_class];
+        const usize      slot_size = POOL_MIN_SIZE << pool_class;
+
+        PoolStats stats {};
+        stats.slotSize = slot_size;
+        stats.slabs    = current.slabs;
+        stats.used     = current.used;
+        stats.capacity = current.slabs * (POOL_SLAB_SIZE / slot_size);
+        return stats;
+    }
+    PoolStats PoolBlock::getChunkStats() const {
+        PoolStats stats {};
+        stats.slotSize = POOL_CHUNK_SIZE;
+        stats.slabs    = chunks.slabs;
+        stats.used     = chunks.used;
+        stats.capacity = chunks.slabs;
+        return stats;
+    }
+    void PoolBlock::logStats() const {
+        FR_LOG_INFO(ALLOCATOR, "Pool memory occupancy");
+        for (u32 pool_class = 0; pool_class < POOL_CLASS_COUNT; pool_class++) {
+            const PoolStats stats = getStats(pool_class);
+            FR_LOG_INFO(
+                ALLOCATOR,
+                "  %zu bytes: %zu out of %zu slots in %zu slabs",
+                stats.slotSize,
+                stats.used,
+                stats.capacity,
+                stats.slabs);
+        }
+        const PoolStats stats = getChunkStats();
+        FR_LOG_INFO(
+            ALLOCATOR,
+            "  %zu byte chunks: %zu out of %zu",
+            stats.slotSize,
+            stats.used,
+            stats.capacity);
+    }
+
+    void PoolBlock::allocBatch(u32 pool_class, usize* offsets, u32 count) {
+        SpinGuard guard(&lock);
+        for (u32 i = 0; i < count; i++) offsets[i] = popSlot(pool_class);
+    }
+    void PoolBlock::freeBatch(u32 pool_class, const usize* offsets, u32 count) {
+        SpinGuard guard(&lock);
+        for (u32 i = 0; i < count; i++) pushSlot(pool_class, offsets[i]);
+    }
+
+    Pointer<u8> PoolBlock::allocChunk() {
+        usize offset {};
+        {
+            SpinGuard guard(&lock);
+            offset = chunks.freeList;
+            if (offset != POOL_NONE) chunks.freeList = *(usize*)(*base + offset);
+            chunks.used++;
+        }
+
+        if (offset == POOL_NONE) {
+            // Taken outside the lock, the dynamic block has its own.
+            const Pointer<u8> chunk = allocator->getDynamicBlock()->allocAligned(
+                POOL_CHUNK_SIZE, POOL_MAX_SIZE, TAG_POOL);
+            offset = chunk.getOffset();
+
+            SpinGuard guard(&lock);
+            chunks.slabs++;
+        }
+        markSlotUsed((ptr)(*base + offset), POOL_CHUNK_SIZE, POOL_CHUNK_SIZE);
+        return Pointer<u8>(offset, base, POOL_CHUNK_SIZE, allocatorBuffer, 0);
+    }
+    void PoolBlock::freeChunk(Pointer<u8> chunk) {
+        markSlotFree(chunk.get(), POOL_CHUNK_SIZE, POOL_CHUNK_SIZE);
+
+        SpinGuard guard(&lock);
+        *(usize*)chunk.get() = chunks.freeList;
+        chunks.freeList      = chunk.getOffset();
+        chunks.used--;
+    }
+
+    usize PoolBlock::allocSlot(u32 pool_class) {
+        SpinGuard guard(&lock);
+        return popSlot(pool_class);
+    }
+    void PoolBlock::freeSlot(u32 pool_class, usize offset) {
+        SpinGuard guard(&lock);
+        pushSlot(pool_class, offset);
+    }
+    usize PoolBlock::popSlot(u32 pool_class) {
+        PoolClass &current = classes[pool_class];
+
+        usize offset = current.freeList;
+        if (offset != POOL_NONE) {
+            current.freeList = *(usize*)(*base + offset);
+            current.used++;
+            return offset;
+        }
+
+        // Slots in a fresh slab are handed out in order, so nothing is threaded up front. Slabs are
+        // aligned to the largest slot, which keeps every slot aligned to its own size.
+        if (current.next == current.end) {
+            const Pointer<u8> slab = allocator->getDynamicBlock()->allocAligned(
+                POOL_SLAB_SIZE, POOL_MAX_SIZE, TAG_POOL);
+            poisonMemory(slab.get(), POOL_SLAB_SIZE, SHADOW_UNALLOCATED);
+            current.next = slab.getOffset();
+            current.end  = current.next + POOL_SLAB_SIZE;
+            current.slabs++;
+        }
+
+        offset        = current.next;
+        current.next += POOL_MIN_SIZE << pool_class;
+        current.used++;
+        return offset;
+    }
+    void PoolBlock::pushSlot(u32 pool_class, usize offset) {
+        PoolClass &current = classes[pool_class];
+
+        *(usize*)(*base + offset) = current.freeList;
+        current.freeList          = offset;
+        current.used--;
+    }
+
+    ThreadCache::ThreadCache(Allocator* _allocator) :
+        poolBlock(_allocator->getPoolBlock()),
+        base(_allocator->getDynamicBlock()->getBase()),
+        allocatorBuffer(_allocator->getBuffer()) {}
+    ThreadCache::~ThreadCache() { flush(); }
+
+    void ThreadCache::flush() {
+        for (u32 pool_class = 0; pool_class < POOL_CLASS_COUNT; pool_class++)
+            flush(pool_class, counts[pool_class]);
+    }
+
+    void ThreadCache::refill(u32 pool_class) {
+        poolBlock->allocBatch(pool_class, slots[pool_class], THREAD_CACHE_SIZE / 2);
+        counts[pool_class] = THREAD_CACHE_SIZE / 2;
+    }
+    void ThreadCache::flush(u32 pool_class, u32 count) {
+        if (!count) return;
+        counts[pool_class] -= count;
+        poolBlock->freeBatch(pool_class, &slots[pool_class][counts[pool_class]], count);
+    }
+}
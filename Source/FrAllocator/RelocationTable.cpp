@@ -0,0 +1,59 @@
+#include <FrogEngine/Allocator.h>
+#include <FrogEngine/Atomic.h>
+#include <FrogEngine/Log.h>
+#include <FrogEngine/Utility.h>
+#include <FrogEngine/VirtualMemory.h>
+
+namespace FrogEngine {
+    constexpr usize RELOCATION_RESERVE { RELOCATION_MAX_COUNT * sizeof(RelocationEntry) };
+
+    RelocationTable::RelocationTable() {}
+    RelocationTable::~RelocationTable() {
+        if (entries) releaseMemory(entries, RELOCATION_RESERVE);
+    }
+
+    u32 RelocationTable::acquire(uptr address) {
+        SpinGuard guard(&lock);
+
+        u32 index = freeList;
+        if (index != RELOCATION_NONE) {
+            freeList = (u32)entries[index].address;
+        } else {
+            // The range is only reserved once something asks for movable memory.
+            if (!entries) {
+                entries = (RelocationEntry*)reserveMemory(RELOCATION_RESERVE);
+                if (!entries)
+                    FR_LOG_ERROR(ALLOCATOR, "Failed to reserve the relocation table");
+            }
+            if (count == RELOCATION_MAX_COUNT)
+                FR_LOG_ERROR(ALLOCATOR, "Ran out of relocation entries (%u)", RELOCATION_MAX_COUNT);
+            if (count == committed) {
+                const usize page = getPageSize();
+                if (!commitMemory((u8*)entries + committed * sizeof(RelocationEntry), page))
+                    FR_LOG_ERROR(
+                        ALLOCATOR, "Failed to commit %zu bytes of relocation entries", page);
+                committed += (u32)(page / sizeof(RelocationEntry));
+            }
+            index = count++;
+        }
+
+        entries[index].address = address;
+        entries[index].pins    = 0;
+        return index;
+    }
+    void RelocationTable::release(u32 index) {
+        SpinGuard guard(&lock);
+
+        RelocationEntry &entry = entries[index];
+        entry.address          = freeList;
+        entry.pins             = 0;
+        entry.generation++;
+        freeList = index;
+    }
+
+    RelocationEntry* RelocationTable::getEntry(u32 index) { return &entries[index]; }
+    u32 RelocationTable::getIndex(const RelocationEntry* entry) const {
+        return (u32)(entry - entries);
+    }
+    u32 RelocationTable::getCount() const { return count; }
+}
@@ -0,0 +1,92 @@
+#include <string.h>
+
+#include <FrogEngine/Log.h>
+#include <FrogEngine/Shadow.h>
+#include <FrogEngine/Utility.h>
+#include <FrogEngine/VirtualMemory.h>
+
+#ifdef FR_MEMORY_SHADOW
+namespace FrogEngine {
+    ShadowMap shadowMap {};
+
+    static usize shadowReserve {};
+    static usize shadowCommitted {};
+
+    void mapShadow(ptr arena, usize _size) {
+        if (shadowMap.shadow) {
+            FR_LOG_WARNING(ALLOCATOR, "Shadow memory already covers another arena");
+            return;
+        }
+
+        shadowReserve   = _size >> SHADOW_SHIFT;
+        shadowCommitted = 0;
+        shadowMap.shadow = (u8*)reserveMemory(shadowReserve);
+        if (!shadowMap.shadow)
+            FR_LOG_ERROR(ALLOCATOR, "Failed to reserve %zu bytes of shadow memory", shadowReserve);
+        shadowMap.start = (uptr)arena;
+        shadowMap.end   = (uptr)arena;
+    }
+    void commitShadow(usize _size) {
+        if (!shadowMap.shadow) return;
+
+        const usize page   = getPageSize();
+        const usize needed = (_size >> SHADOW_SHIFT) + page - 1 & ~(page - 1);
+        if (needed > shadowCommitted) {
+            if (!commitMemory(shadowMap.shadow + shadowCommitted, needed - shadowCommitted))
+                FR_LOG_ERROR(
+                    ALLOCATOR,
+                    "Failed to commit %zu bytes of shadow memory",
+                    needed - shadowCommitted);
+            shadowCommitted = needed;
+        }
+        shadowMap.end = shadowMap.start + _size;
+    }
+    void unmapShadow(ptr arena) {
+        if (!shadowMap.shadow || shadowMap.start != (uptr)arena) return;
+        releaseMemory(shadowMap.shadow, shadowReserve);
+        shadowMap = {};
+    }
+
+    void setShadow(ptr address, usize _size, u8 kind) {
+        const uptr limit = shadowMap.end - shadowMap.start;
+        const uptr begin = (uptr)address - shadowMap.start;
+        if (!_size || begin >= limit) return;
+        const uptr end = begin + _size < limit ? begin + _size : limit;
+
+        u8* shadow = shadowMap.shadow;
+        if (kind == SHADOW_ADDRESSABLE) {
+            // Bytes in front of `address` in its first granule are treated as addressable too,
+            // which holds for every block that hands out unaligned memory.
+            const uptr first = begin >> SHADOW_SHIFT;
+            memset(shadow + first, 0, (end >> SHADOW_SHIFT) - first);
+            if (end & 15) shadow[end >> SHADOW_SHIFT] = (u8)(end & 15);
+            return;
+        }
+
+        // A leading partial granule keeps its addressable prefix.
+        uptr granule = begin >> SHADOW_SHIFT;
+        if (begin & 15) shadow[granule++] = (u8)(begin & 15);
+        const uptr last = end + 15 >> SHADOW_SHIFT;
+        if (last > granule) memset(shadow + granule, kind, last - granule);
+    }
+
+    void reportShadow(const void* address, usize _size) {
+        const uptr begin = (uptr)address - shadowMap.start;
+        for (uptr byte = begin; byte < begin + _size; byte++) {
+            const u8 shadow = shadowMap.shadow[byte >> SHADOW_SHIFT];
+            if (!shadow || (shadow < SHADOW_GRANULE && (byte & 15) < shadow)) continue;
+
+            const char* reason = "out of bounds";
+            if (shadow == SHADOW_FREED) reason = "use after free";
+            if (shadow == SHADOW_UNALLOCATED) reason = "unallocated";
+            FR_LOG_ERROR(
+                ALLOCATOR,
+                "Invalid %zu byte access at %p (%s, arena offset %zu)",
+                _size,
+                address,
+                reason,
+                (usize)byte);
+        }
+    }
+}
+#endif
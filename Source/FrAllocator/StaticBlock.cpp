@@ -1,6 +1,9 @@
+#include <string.h>
+
 #include <FrogEngine/Allocator.h>
 #include <FrogEngine/Log.h>
 #include <FrogEngine/Pointer.h>
+#include <FrogEngine/Shadow.h>
 #include <FrogEngine/Utility.h>
 
 namespace FrogEngine {
@@ -10,31 +13,63 @@ namespace FrogEngine {
     void StaticBlock::init(ptr _buffer, usize _size) {
         buffer = _buffer;
         size   = _size;
+        poisonMemory(buffer, size, SHADOW_UNALLOCATED);
+    }
+    Pointer<u8> StaticBlock::alloc(usize _size, AllocTag tag) {
+        return allocAligned(_size, 1, tag);
     }
-    Pointer<u8> StaticBlock::alloc(usize _size) {
-        if (index + _size > size) {
-            logError(
-                "%sALLOCATOR%s: Tried to alloc %zu when only %zu is allocated",
-                FR_LOG_FORMAT_YELLOW,
-                FR_LOG_FORMAT_RESET,
-                index + _size,
-                size);
+    Pointer<u8> StaticBlock::allocAligned(usize _size, usize alignment, AllocTag tag) {
+        allocator->checkAlignment(alignment);
+        const uptr offset = alignUp((uptr)buffer + index, alignment) - (uptr)buffer;
+        if (offset + _size > size) {
+            FR_LOG_ERROR(
+                ALLOCATOR, "Tried to alloc %zu when only %zu is allocated", offset + _size, size);
             allocator->abort();
         }
 
-        logInfo(
-            "%sALLOCATOR%s: Allocated %zu out of %zu static memory",
-            FR_LOG_FORMAT_YELLOW,
-            FR_LOG_FORMAT_RESET,
-            index + _size,
-            size);
-        Pointer<u8> result(index, (uptr*)&buffer, _size, allocator->getBuffer(), 0);
-        index += _size;
+        FR_LOG_TRACE(ALLOCATOR, "Allocated %zu out of %zu static memory", offset + _size, size);
+        Pointer<u8> result(offset, (uptr*)&buffer, _size, allocator->getBuffer(), 0);
+        unpoisonMemory((u8*)buffer + offset, _size);
+#if defined(FR_DEBUG) || defined(FR_MEMORY_PROFILE)
+        // Once the runs are full the last one absorbs the rest, so only its credit is inexact.
+        // Alignment padding is charged to the allocation after it.
+        if (!tagRunCount || (tagRuns[tagRunCount - 1].tag != tag && tagRunCount < TAG_RUN_COUNT))
+            tagRuns[tagRunCount++] = { index, tag };
+        allocator->getProfile()->onAlloc(tag, offset + _size - index);
+#endif
+        index = offset + _size;
+        if (index > peak) peak = index;
         return result;
     }
 
+    usize StaticBlock::getMarker() const { return index; }
+    void  StaticBlock::freeToMarker(usize marker) {
+        if (marker > index) {
+            FR_LOG_ERROR(ALLOCATOR, "Tried to free to %zu when only %zu is in use", marker, index);
+            allocator->abort();
+        }
+
+#if defined(FR_DEBUG) || defined(FR_MEMORY_PROFILE)
+        for (usize end = index; tagRunCount && end > marker;) {
+            const TagRun &run   = tagRuns[tagRunCount - 1];
+            const usize   begin = run.offset > marker ? run.offset : marker;
+            allocator->getProfile()->onFree(run.tag, end - begin);
+            end = begin;
+            if (run.offset >= marker) tagRunCount--;
+        }
+#endif
+        memset((u8*)buffer + marker, 0, index - marker);
+        poisonMemory((u8*)buffer + marker, index - marker, SHADOW_FREED);
+        index = marker;
+        FR_LOG_TRACE(ALLOCATOR, "Freed to %zu out of %zu static memory", index, size);
+    }
+
     void StaticBlock::setBuffer(ptr _buffer) { buffer = _buffer; }
 
     const ptr StaticBlock::getBuffer() const { return buffer; }
     usize     StaticBlock::getSize() const { return size; }
+    usize     StaticBlock::getPeak() const { return peak; }
+
+    StaticScope::StaticScope(StaticBlock* _block) : block(_block), marker(_block->getMarker()) {}
+    StaticScope::~StaticScope() { block->freeToMarker(marker); }
 }
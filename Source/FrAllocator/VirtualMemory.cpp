@@ -0,0 +1,108 @@
+#include <FrogEngine/Runtime.h>
+#include <FrogEngine/Utility.h>
+#include <FrogEngine/VirtualMemory.h>
+
+#ifdef FR_OS_WINDOWS
+#    include <Windows.h>
+#elif defined(FR_OS_LINUX)
+#    include <elf.h>
+#    include <sys/mman.h>
+#else
+#    include <sys/mman.h>
+#    include <unistd.h>
+#endif
+
+namespace FrogEngine {
+#ifdef FR_OS_WINDOWS
+    usize getPageSize() {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return info.dwPageSize;
+    }
+    ptr reserveMemory(usize _size) {
+        return VirtualAlloc(nullptr, _size, MEM_RESERVE, PAGE_NOACCESS);
+    }
+    bool commitMemory(ptr address, usize _size) {
+        return VirtualAlloc(address, _size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+    }
+    void releaseMemory(ptr address, usize _size) { VirtualFree(address, 0, MEM_RELEASE); }
+
+    // Large pages on Windows need SeLockMemoryPrivilege and cannot be committed into a
+    // reserved range, so the arena always uses normal pages.
+    bool hasTransparentHugePages() { return false; }
+    bool adviseHugePages(ptr address, usize _size) { return false; }
+    bool commitHugePages(ptr address, usize _size) { return false; }
+#else
+    usize getPageSize() {
+#    ifdef FR_OS_LINUX
+        const usize page = getAuxiliary(AT_PAGESZ);
+        return page ? page : 4'096;
+#    else
+        return (usize)sysconf(_SC_PAGESIZE);
+#    endif
+    }
+    ptr reserveMemory(usize _size) {
+        // Over reserve and trim both ends so the range starts on a huge page boundary.
+        const usize reserved = _size + HUGE_PAGE_SIZE;
+        u8*         address  = (u8*)mapMemory(
+            nullptr, reserved, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE);
+        if (!address) return nullptr;
+
+        u8* aligned = (u8*)((uptr)address + HUGE_PAGE_SIZE - 1 & ~(HUGE_PAGE_SIZE - 1));
+        if (aligned != address) unmapMemory(address, aligned - address);
+        if (aligned + _size != address + reserved)
+            unmapMemory(aligned + _size, address + reserved - (aligned + _size));
+        return aligned;
+    }
+    bool commitMemory(ptr address, usize _size) {
+        return protectMemory(address, _size, PROT_READ | PROT_WRITE);
+    }
+    void releaseMemory(ptr address, usize _size) { unmapMemory(address, _size); }
+
+    bool hasTransparentHugePages() {
+#    ifdef FR_OS_LINUX
+        const FileHandle file =
+            openFile("/sys/kernel/mm/transparent_hugepage/enabled", FILE_READ);
+        if (file == FILE_NONE) return false;
+
+        char      mode[128] = { 0 };
+        const i64 length    = readFile(file, mode, sizeof(mode) - 1);
+        closeFile(file);
+        if (length <= 0) return false;
+
+        // The active mode is the one in brackets.
+        for (const char* cursor = mode; *cursor; cursor++)
+            if (*cursor == '[') return cursor[1] != 'n';
+        return false;
+#    else
+        return false;
+#    endif
+    }
+    bool adviseHugePages(ptr address, usize _size) {
+#    ifdef MADV_HUGEPAGE
+        return adviseMemory(address, _size, MADV_HUGEPAGE);
+#    else
+        return false;
+#    endif
+    }
+    bool commitHugePages(ptr address, usize _size) {
+#    ifdef MAP_HUGETLB
+        // Mapping over the reservation replaces it with huge pages. Without MAP_NORESERVE the
+        // kernel reserves them now, so this fails instead of faulting later.
+        const ptr result = mapMemory(
+            address,
+            _size,
+            PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_HUGETLB);
+        if (result) return true;
+
+        // A failed MAP_FIXED may have dropped the reservation, so put it back.
+        mapMemory(
+            address, _size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_NORESERVE);
+        return false;
+#    else
+        return false;
+#    endif
+    }
+#endif
+}
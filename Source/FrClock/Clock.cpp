@@ -0,0 +1,120 @@
+#include <FrogEngine/Atomic.h>
+#include <FrogEngine/Clock.h>
+#include <FrogEngine/Runtime.h>
+#include <FrogEngine/Syscall.h>
+#include <FrogEngine/Utility.h>
+
+#ifdef FR_OS_WINDOWS
+#    include <windows.h>
+#else
+#    include <errno.h>
+#    include <time.h>
+#endif
+
+namespace FrogEngine {
+    // Spin window before any sleep has been measured, and the least it shrinks to.
+    constexpr u64 CLOCK_INITIAL_SLEEP_ERROR { 1'000 * NANOSECONDS_PER_MICROSECOND };
+    constexpr u64 CLOCK_MINIMUM_SPIN { 50 * NANOSECONDS_PER_MICROSECOND };
+    // Weight of the newest sleep in the moving average of its overshoot, as a shift.
+    constexpr u32 CLOCK_ERROR_SHIFT { 3 };
+
+#ifdef FR_OS_WINDOWS
+    void sleepUntil(u64 time) {
+        const u64 now = getTime();
+        if (time <= now) return;
+
+        // High resolution timers wake within a few hundred microseconds, where Sleep() rounds
+        // up to the 15.6 ms system tick.
+        static thread_local HANDLE timer = CreateWaitableTimerExW(
+            nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+        if (!timer) {
+            Sleep((DWORD)((time - now) / NANOSECONDS_PER_MILLISECOND));
+            return;
+        }
+        // Negative due times are relative, in 100 ns units.
+        LARGE_INTEGER due;
+        due.QuadPart = -(LONGLONG)((time - now) / 100);
+        if (SetWaitableTimer(timer, &due, 0, nullptr, nullptr, FALSE))
+            WaitForSingleObject(timer, INFINITE);
+    }
+#elif defined(FR_OS_LINUX)
+    void sleepUntil(u64 time) {
+        struct timespec deadline {};
+        deadline.tv_sec  = (time_t)(time / NANOSECONDS_PER_SECOND);
+        deadline.tv_nsec = (long)(time % NANOSECONDS_PER_SECOND);
+        // Absolute deadlines, so a signal interrupting the sleep just sleeps again.
+        while (systemCall(
+                   SYSCALL_CLOCK_NANOSLEEP, CLOCK_MONOTONIC, TIMER_ABSTIME, (i64)&deadline, 0)
+               == -EINTR) {}
+    }
+#else
+    void sleepUntil(u64 time) {
+        const u64 now = getTime();
+        if (time <= now) return;
+        struct timespec duration {};
+        duration.tv_sec  = (time_t)((time - now) / NANOSECONDS_PER_SECOND);
+        duration.tv_nsec = (long)((time - now) % NANOSECONDS_PER_SECOND);
+        nanosleep(&duration, nullptr);
+    }
+#endif
+    void sleepFor(u64 duration) { sleepUntil(getTime() + duration); }
+
+    FrameLimiter::FrameLimiter(u32 rate) : sleepError(CLOCK_INITIAL_SLEEP_ERROR) {
+        setRate(rate);
+    }
+
+    void FrameLimiter::setRate(u32 rate) {
+        period   = rate ? NANOSECONDS_PER_SECOND / rate : 0;
+        deadline = 0;
+    }
+
+    u64 FrameLimiter::wait() {
+        u64 now = getTime();
+        if (period && deadline) {
+            const u64 spin = getSpinWindow();
+            if (now + spin < deadline) {
+                const u64 wake = deadline - spin;
+                sleepUntil(wake);
+                now = getTime();
+
+                // Stalls longer than a quarter frame are preemption rather than sleep
+                // latency, and a wider spin window would not have caught them.
+                u64 error = now > wake ? now - wake : 0;
+                if (error > period / 4) error = period / 4;
+                sleepError += (error >> CLOCK_ERROR_SHIFT) - (sleepError >> CLOCK_ERROR_SHIFT);
+            }
+            while (now < deadline) {
+                FR_CPU_PAUSE();
+                now = getTime();
+            }
+        }
+
+        if (period)
+            deadline = deadline && now < deadline + period ? deadline + period : now + period;
+        const u64 delta = last ? now - last : 0;
+        last            = now;
+        return delta;
+    }
+
+    u64 FrameLimiter::getPeriod() const { return period; }
+    // Twice the average overshoot covers most of the spread around it.
+    u64 FrameLimiter::getSpinWindow() const {
+        const u64 window = sleepError * 2;
+        return window > CLOCK_MINIMUM_SPIN ? window : CLOCK_MINIMUM_SPIN;
+    }
+
+    FixedStep::FixedStep(u64 _step, u32 _maxSteps) : step(_step), maxSteps(_maxSteps) {}
+
+    u32 FixedStep::advance(u64 elapsed) {
+        accumulator += elapsed;
+        u64 steps    = accumulator / step;
+        if (steps > maxSteps) steps = maxSteps;
+        accumulator  = steps < maxSteps ? accumulator - steps * step : accumulator % step;
+        stepCount   += steps;
+        return (u32)steps;
+    }
+
+    f64 FixedStep::getAlpha() const { return (f64)accumulator / (f64)step; }
+    f64 FixedStep::getStepSeconds() const { return (f64)step / NANOSECONDS_PER_SECOND; }
+    u64 FixedStep::getStepCount() const { return stepCount; }
+}
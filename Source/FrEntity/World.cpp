@@ -0,0 +1,225 @@
+#include <string.h>
+
+#include <FrogEngine/Allocator.h>
+#include <FrogEngine/Entity.h>
+#include <FrogEngine/Log.h>
+#include <FrogEngine/Utility.h>
+
+namespace FrogEngine {
+    constexpr u32 ARCHETYPE_NONE { ~0u };
+
+    static ComponentInfo componentInfos[COMPONENT_MAX_COUNT];
+    static u32           componentCount {};
+
+    u32 addComponentType(usize _size, usize alignment) {
+        if (componentCount == COMPONENT_MAX_COUNT)
+            FR_LOG_ERROR(ENTITY, "Ran out of component types (%u)", COMPONENT_MAX_COUNT);
+        if (alignment > POOL_MAX_SIZE)
+            FR_LOG_ERROR(
+                ENTITY, "Components cannot be aligned to more than %zu bytes", POOL_MAX_SIZE);
+
+        componentInfos[componentCount] = { (u32)_size, (u32)alignment };
+        return componentCount++;
+    }
+    const ComponentInfo* getComponentInfo(u32 component) { return &componentInfos[component]; }
+
+    // Doubles `array` until it holds `count` elements.
+    template <typename T>
+    static void growArray(DynamicBlock* block, Pointer<T>* array, u32* capacity, u32 count) {
+        if (count <= *capacity) return;
+        u32 target = *capacity ? *capacity * 2 : 16;
+        while (target < count) target *= 2;
+
+        if (*capacity)
+            *array = block->realloc(*array, *capacity * sizeof(T), target * sizeof(T));
+        else
+            *array = block->alloc<T>(target, alignof(T), TAG_ENTITY);
+        *capacity = target;
+    }
+
+    // Byte offset of every column for `rows` rows, or 0 when they do not fit in a chunk.
+    static usize layoutColumns(ComponentMask mask, u32 rows, u16* columns) {
+        usize offset = sizeof(Entity) * rows;
+        for (ComponentMask bits = mask; bits; bits &= bits - 1) {
+            const u32            id   = (u32)__builtin_ctzll(bits);
+            const ComponentInfo* info = getComponentInfo(id);
+            offset                    = alignUp(offset, info->alignment);
+            if (columns) columns[id] = (u16)offset;
+            offset += (usize)info->size * rows;
+        }
+        return offset <= POOL_CHUNK_SIZE ? offset : 0;
+    }
+
+    World::World(Allocator* _allocator) :
+        block(_allocator->getDynamicBlock()),
+        pool(_allocator->getPoolBlock()),
+        archetypeLookup(block, TAG_ENTITY) {}
+    World::~World() {
+        for (u32 i = 0; i < archetypeCount; i++) {
+            Archetype &archetype = archetypes[i];
+            for (u32 j = 0; j < archetype.chunkCount; j++)
+                pool->freeChunk(archetype.chunks[j].data);
+            if (archetype.chunkCapacity) block->dealloc(archetype.chunks, archetype.chunkCapacity);
+        }
+        if (archetypeCapacity) block->dealloc(archetypes, archetypeCapacity);
+        if (recordCapacity) block->dealloc(records, recordCapacity);
+    }
+
+    Entity World::create() { return createEntity(0); }
+    void   World::destroy(Entity entity) {
+        EntityRecord* record = getRecord(entity);
+        removeRow(record);
+
+        record->archetype = ARCHETYPE_NONE;
+        record->chunk     = freeRecord;
+        record->generation++;
+        freeRecord = entity.getIndex();
+        aliveCount--;
+    }
+    bool World::isAlive(Entity entity) const {
+        if (!entity || entity.getIndex() >= recordCount) return false;
+        const EntityRecord &record = records[entity.getIndex()];
+        return record.archetype != ARCHETYPE_NONE
+            && (record.generation & ENTITY_GENERATION_MASK) == entity.getGeneration();
+    }
+
+    u32 World::getCount() const { return aliveCount; }
+    u32 World::getArchetypeCount() const { return archetypeCount; }
+
+    // Components of new rows are left uninitialized; create() constructs them right after.
+    Entity World::createEntity(ComponentMask mask) {
+        u32 index = freeRecord;
+        if (index != ENTITY_NONE) {
+            freeRecord = records[index].chunk;
+        } else {
+            if (recordCount > ENTITY_INDEX_MASK)
+                FR_LOG_ERROR(ENTITY, "Ran out of entities (%u)", ENTITY_INDEX_MASK + 1);
+            growArray(block, &records, &recordCapacity, recordCount + 1);
+            index          = recordCount++;
+            records[index] = {};
+        }
+
+        const u32     archetype = findArchetype(mask);
+        EntityRecord* record    = &records[index];
+        const Entity  entity(index, record->generation);
+        pushRow(archetype, entity, record);
+        aliveCount++;
+        return entity;
+    }
+
+    ComponentMask World::getMask(Entity entity) const {
+        return archetypes[getRecord(entity)->archetype].mask;
+    }
+    // Moves the entity into the archetype of `mask`, carrying over the components both share.
+    void World::setMask(Entity entity, ComponentMask mask) {
+        EntityRecord* record = getRecord(entity);
+        if (archetypes[record->archetype].mask == mask) return;
+
+        const u32          target = findArchetype(mask);
+        const EntityRecord old    = *record;
+        pushRow(target, entity, record);
+
+        const Archetype &from        = archetypes[old.archetype];
+        const Archetype &to          = archetypes[target];
+        u8* const        source      = from.chunks[old.chunk].data.get();
+        u8* const        destination = to.chunks[record->chunk].data.get();
+        for (ComponentMask bits = from.mask & mask; bits; bits &= bits - 1) {
+            const u32 id   = (u32)__builtin_ctzll(bits);
+            const u32 size = getComponentInfo(id)->size;
+            memcpy(
+                destination + to.columns[id] + (usize)size * record->row,
+                source + from.columns[id] + (usize)size * old.row,
+                size);
+        }
+
+        removeRow(&old);
+    }
+    u8* World::getComponent(Entity entity, u32 component) {
+        const EntityRecord* record    = getRecord(entity);
+        const Archetype    &archetype = archetypes[record->archetype];
+        if (!(archetype.mask & (ComponentMask)1 << component)) return nullptr;
+
+        u8* const data = archetype.chunks[record->chunk].data.get();
+        return data + archetype.columns[component]
+             + (usize)getComponentInfo(component)->size * record->row;
+    }
+
+    World::EntityRecord* World::getRecord(Entity entity) const {
+        if (!isAlive(entity))
+            FR_LOG_ERROR(ENTITY, "Used destroyed entity %u", entity.getIndex());
+        return &records[entity.getIndex()];
+    }
+
+    u32 World::findArchetype(ComponentMask mask) {
+        const u32* found = archetypeLookup.find(mask);
+        if (found) return *found;
+
+        // As many rows as fit once every column is aligned.
+        usize row_size = sizeof(Entity);
+        for (ComponentMask bits = mask; bits; bits &= bits - 1)
+            row_size += getComponentInfo((u32)__builtin_ctzll(bits))->size;
+        u32 rows = (u32)(POOL_CHUNK_SIZE / row_size);
+        while (rows && !layoutColumns(mask, rows, nullptr)) rows--;
+        if (!rows)
+            FR_LOG_ERROR(ENTITY, "Components of %zu bytes do not fit in a chunk", row_size);
+
+        growArray(block, &archetypes, &archetypeCapacity, archetypeCount + 1);
+        Archetype &archetype   = archetypes[archetypeCount];
+        archetype              = {};
+        archetype.mask         = mask;
+        archetype.rowsPerChunk = rows;
+        layoutColumns(mask, rows, archetype.columns);
+
+        archetypeLookup.insert(mask, archetypeCount);
+        return archetypeCount++;
+    }
+
+    // Appends a row to the last chunk, taking a new chunk from the pool when it is full.
+    void World::pushRow(u32 archetype_index, Entity entity, EntityRecord* record) {
+        Archetype &archetype = archetypes[archetype_index];
+        if (!archetype.chunkCount
+            || archetype.chunks[archetype.chunkCount - 1].count == archetype.rowsPerChunk) {
+            growArray(
+                block, &archetype.chunks, &archetype.chunkCapacity, archetype.chunkCount + 1);
+            archetype.chunks[archetype.chunkCount++] = { pool->allocChunk(), 0 };
+        }
+
+        EntityChunk &chunk = archetype.chunks[archetype.chunkCount - 1];
+        ((Entity*)chunk.data.get())[chunk.count] = entity;
+
+        record->archetype = archetype_index;
+        record->chunk     = archetype.chunkCount - 1;
+        record->row       = chunk.count++;
+    }
+    // Fills the hole with the archetype's last row and returns emptied chunks to the pool.
+    void World::removeRow(const EntityRecord* record) {
+        Archetype   &archetype = archetypes[record->archetype];
+        EntityChunk &last      = archetype.chunks[archetype.chunkCount - 1];
+        const u32    last_row  = last.count - 1;
+
+        if (record->chunk != archetype.chunkCount - 1 || record->row != last_row) {
+            u8* const    hole  = archetype.chunks[record->chunk].data.get();
+            u8* const    tail  = last.data.get();
+            const Entity moved = ((Entity*)tail)[last_row];
+
+            ((Entity*)hole)[record->row] = moved;
+            for (ComponentMask bits = archetype.mask; bits; bits &= bits - 1) {
+                const u32 id   = (u32)__builtin_ctzll(bits);
+                const u32 size = getComponentInfo(id)->size;
+                memcpy(
+                    hole + archetype.columns[id] + (usize)size * record->row,
+                    tail + archetype.columns[id] + (usize)size * last_row,
+                    size);
+            }
+
+            EntityRecord &moved_record = records[moved.getIndex()];
+            moved_record.chunk         = record->chunk;
+            moved_record.row           = record->row;
+        }
+
+        if (!--last.count) {
+            pool->freeChunk(last.data);
+            archetype.chunkCount--;
+        }
+    }
+}
@@ -0,0 +1,243 @@
+#include <FrogEngine/Allocator.h>
+#include <FrogEngine/Atomic.h>
+#include <FrogEngine/Job.h>
+#include <FrogEngine/Log.h>
+#include <FrogEngine/Thread.h>
+#include <FrogEngine/Utility.h>
+
+namespace FrogEngine {
+    // Failed attempts to find work before an idle worker goes to sleep.
+    constexpr u32 JOB_SPIN_COUNT { 256 };
+
+    static thread_local u32 workerIndex { JOB_NONE };
+
+    JobSystem::JobSystem(Allocator* _allocator) :
+        allocator(_allocator), block(_allocator->getDynamicBlock()) {}
+    JobSystem::~JobSystem() {
+        if (!workerCount) return;
+
+        // Jobs still queued are dropped; wait on their counters before shutting down.
+        __atomic_store_n(&running, false, __ATOMIC_RELEASE);
+        __atomic_add_fetch(&epoch, 1, __ATOMIC_SEQ_CST);
+        wakeAddress(&epoch, ~0u);
+        for (u32 i = 0; i < workerCount; i++) workers[i].~Worker();
+        workerIndex = JOB_NONE;
+
+        block->dealloc(workers, workerCount);
+        block->dealloc(jobs, JOB_POOL_SIZE);
+    }
+
+    void JobSystem::init(u32 _workerCount) {
+        if (workerCount) {
+            FR_LOG_WARNING(JOB, "Called init() after initialization");
+            return;
+        }
+        if (!_workerCount) _workerCount = getCoreCount();
+        if (_workerCount > JOB_MAX_WORKERS) _workerCount = JOB_MAX_WORKERS;
+
+        jobs = block->allocIsolated<Job>(JOB_POOL_SIZE, TAG_JOB);
+        for (u32 i = 0; i < JOB_POOL_SIZE; i++)
+            jobs[i].next = i + 1 < JOB_POOL_SIZE ? i + 1 : JOB_NONE;
+        freeJobs = 0;
+
+        workers = block->allocIsolated<Worker>(_workerCount, TAG_JOB);
+        for (u32 i = 0; i < _workerCount; i++) {
+            Worker* worker = new (&workers[i]) Worker();
+            worker->system = this;
+            worker->index  = i;
+            worker->random = i * 0x9E'37'79'B9 + 1;
+        }
+        workerCount = _workerCount;
+        running     = true;
+        workerIndex = 0;
+
+        for (u32 i = 1; i < workerCount; i++)
+            if (!workers[i].thread.start(work, &workers[i]))
+                FR_LOG_ERROR(JOB, "Failed to start worker %u", i);
+
+        FR_LOG_INFO(JOB, "Started %u workers", workerCount);
+    }
+
+    void JobSystem::wait(JobCounter* counter) {
+        while (!counter->isDone())
+            if (!runOnce()) FR_CPU_PAUSE();
+    }
+
+    u32 JobSystem::getWorkerCount() const { return workerCount; }
+    u32 JobSystem::getWorkerIndex() const { return workerIndex; }
+
+    // Treiber stack over pool indices. The tag changes on every push and pop, so a slot that
+    // was popped and pushed back in between fails the compare exchange, as does a `next` read
+    // from a slot another thread has already taken and is filling in.
+    u32 JobSystem::allocJob() {
+        u64 head = __atomic_load_n(&freeJobs, __ATOMIC_ACQUIRE);
+        for (;;) {
+            const u32 index = (u32)head;
+            if (index == JOB_NONE) return JOB_NONE;
+            const u32 next     = __atomic_load_n(&jobs[index].next, __ATOMIC_RELAXED);
+            const u64 new_head = (head >> 32) + 1 << 32 | next;
+            if (__atomic_compare_exchange_n(
+                    &freeJobs, &head, new_head, true, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE))
+                return index;
+        }
+    }
+    void JobSystem::freeJob(u32 index) {
+        u64 head = __atomic_load_n(&freeJobs, __ATOMIC_RELAXED);
+        for (;;) {
+            __atomic_store_n(&jobs[index].next, (u32)head, __ATOMIC_RELAXED);
+            const u64 new_head = (head >> 32) + 1 << 32 | index;
+            if (__atomic_compare_exchange_n(
+                    &freeJobs, &head, new_head, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+                return;
+        }
+    }
+
+    void JobSystem::submit(u32 index) {
+        JobCounter* counter = jobs[index].counter;
+        if (counter) __atomic_add_fetch(&counter->value, 1, __ATOMIC_RELAXED);
+
+        if (workerIndex == JOB_NONE || !push(&workers[workerIndex], index)) {
+            execute(index);
+            return;
+        }
+
+        // Pairs with the check in sleep(): either the sleeper sees the new job, or this sees
+        // the sleeper and moves the epoch it waits on.
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&sleepers, __ATOMIC_RELAXED)) {
+            __atomic_add_fetch(&epoch, 1, __ATOMIC_SEQ_CST);
+            wakeAddress(&epoch, 1);
+        }
+    }
+    void JobSystem::execute(u32 index) {
+        Job* job = &jobs[index];
+        job->function(job->payload);
+        JobCounter* counter = job->counter;
+        freeJob(index);
+        if (counter) __atomic_sub_fetch(&counter->value, 1, __ATOMIC_RELEASE);
+    }
+
+    // Chase-Lev deque, following the C11 version by Le, Pop, Cohen and Zappa Nardelli.
+    bool JobSystem::push(Worker* worker, u32 index) {
+        const i64 bottom = __atomic_load_n(&worker->bottom, __ATOMIC_RELAXED);
+        const i64 top    = __atomic_load_n(&worker->top, __ATOMIC_ACQUIRE);
+        if (bottom - top >= JOB_DEQUE_SIZE) return false;
+
+        __atomic_store_n(&worker->deque[bottom & (JOB_DEQUE_SIZE - 1)], index, __ATOMIC_RELAXED);
+        __atomic_store_n(&worker->bottom, bottom + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+    u32 JobSystem::pop(Worker* worker) {
+        const i64 bottom = __atomic_load_n(&worker->bottom, __ATOMIC_RELAXED) - 1;
+        __atomic_store_n(&worker->bottom, bottom, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        i64 top = __atomic_load_n(&worker->top, __ATOMIC_RELAXED);
+
+        if (top > bottom) {
+            __atomic_store_n(&worker->bottom, bottom + 1, __ATOMIC_RELAXED);
+            return JOB_NONE;
+        }
+        u32 index =
+            __atomic_load_n(&worker->deque[bottom & (JOB_DEQUE_SIZE - 1)], __ATOMIC_RELAXED);
+        if (top == bottom) {
+            // Last job: race thieves for it through `top`.
+            if (!__atomic_compare_exchange_n(
+                    &worker->top, &top, top + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+                index = JOB_NONE;
+            __atomic_store_n(&worker->bottom, bottom + 1, __ATOMIC_RELAXED);
+        }
+        return index;
+    }
+    u32 JobSystem::steal(Worker* worker) {
+        i64 top = __atomic_load_n(&worker->top, __ATOMIC_ACQUIRE);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        const i64 bottom = __atomic_load_n(&worker->bottom, __ATOMIC_ACQUIRE);
+        if (top >= bottom) return JOB_NONE;
+
+        const u32 index =
+            __atomic_load_n(&worker->deque[top & (JOB_DEQUE_SIZE - 1)], __ATOMIC_RELAXED);
+        if (!__atomic_compare_exchange_n(
+                &worker->top, &top, top + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+            return JOB_NONE;
+        return index;
+    }
+
+    // Own deque first, then every other worker once starting from a random one.
+    u32 JobSystem::find(u32 thief) {
+        u32 start = 0;
+        if (thief != JOB_NONE) {
+            Worker* worker = &workers[thief];
+            const u32 index = pop(worker);
+            if (index != JOB_NONE) return index;
+
+            worker->random ^= worker->random << 13;
+            worker->random ^= worker->random >> 17;
+            worker->random ^= worker->random << 5;
+            start           = worker->random % workerCount;
+        }
+        for (u32 i = 0; i < workerCount; i++) {
+            const u32 victim = (start + i) % workerCount;
+            if (victim == thief) continue;
+            const u32 index = steal(&workers[victim]);
+            if (index != JOB_NONE) return index;
+        }
+        return JOB_NONE;
+    }
+    bool JobSystem::runOnce() {
+        const u32 index = find(workerIndex);
+        if (index == JOB_NONE) return false;
+        execute(index);
+        return true;
+    }
+
+    void JobSystem::splitRange(
+        RangeFunction function, ptr closure, u32 begin, u32 end, u32 batch, JobCounter* counter) {
+        while (end - begin > batch) {
+            const u32 middle = begin + (end - begin) / 2;
+            run(
+                [this, function, closure, middle, end, batch, counter] {
+                    splitRange(function, closure, middle, end, batch, counter);
+                },
+                counter);
+            end = middle;
+        }
+        if (begin < end) function(closure, begin, end);
+    }
+    u32 JobSystem::getBatchSize(u32 count) const {
+        const u32 batch = count / (workerCount * 8);
+        return batch ? batch : 1;
+    }
+
+    void JobSystem::work(ptr argument) {
+        Worker*    worker = (Worker*)argument;
+        JobSystem* system = worker->system;
+        workerIndex       = worker->index;
+
+        u32 failures = 0;
+        while (__atomic_load_n(&system->running, __ATOMIC_ACQUIRE)) {
+            if (system->runOnce()) {
+                failures = 0;
+            } else if (++failures < JOB_SPIN_COUNT) {
+                FR_CPU_PAUSE();
+            } else {
+                system->sleep();
+                failures = 0;
+            }
+        }
+    }
+    void JobSystem::sleep() {
+        const u32 current = __atomic_load_n(&epoch, __ATOMIC_ACQUIRE);
+        __atomic_add_fetch(&sleepers, 1, __ATOMIC_SEQ_CST);
+
+        // Checked again after announcing the sleep, see submit().
+        bool found = false;
+        for (u32 i = 0; i < workerCount && !found; i++) {
+            const Worker* victim = &workers[i];
+            found = __atomic_load_n(&victim->bottom, __ATOMIC_SEQ_CST)
+                  > __atomic_load_n(&victim->top, __ATOMIC_SEQ_CST);
+        }
+        if (!found && __atomic_load_n(&running, __ATOMIC_ACQUIRE)) waitAddress(&epoch, current);
+
+        __atomic_sub_fetch(&sleepers, 1, __ATOMIC_RELAXED);
+    }
+}
@@ -0,0 +1,276 @@
+#include <FrogEngine/Job.h>
+#include <FrogEngine/Log.h>
+#include <FrogEngine/Runtime.h>
+#include <FrogEngine/TaskGraph.h>
+#include <FrogEngine/Utility.h>
+
+namespace FrogEngine {
+    // Weight of the newest frame in the moving average of task costs, as a shift.
+    constexpr u32 TASK_AVERAGE_SHIFT { 3 };
+
+    static bool conflicts(
+        ResourceMask reads_a, ResourceMask writes_a, ResourceMask reads_b, ResourceMask writes_b) {
+        return (writes_a & (reads_b | writes_b)) | (reads_a & writes_b);
+    }
+
+    TaskGraph::TaskGraph(JobSystem* _jobs) : jobs(_jobs) {}
+    TaskGraph::~TaskGraph() {
+        waitFrames();
+        for (u32 i = 0; i < taskCount; i++) tasks[i].destroy(tasks[i].payload);
+    }
+
+    ResourceMask TaskGraph::addResource() {
+        if (resourceCount == TASK_MAX_RESOURCES) {
+            FR_LOG_ERROR(TASK, "More than %u resources", TASK_MAX_RESOURCES);
+            return 0;
+        }
+        return (ResourceMask)1 << resourceCount++;
+    }
+
+    TaskGraph::Task* TaskGraph::createTask(
+        const char* name, ResourceMask reads, ResourceMask writes) {
+        if (built || taskCount == TASK_MAX_COUNT) {
+            FR_LOG_ERROR(TASK, "Cannot add %s, the graph is %s", name, built ? "built" : "full");
+            return nullptr;
+        }
+        Task* task   = &tasks[taskCount];
+        task->name   = name;
+        task->reads  = reads;
+        task->writes = writes;
+        return task;
+    }
+
+    void TaskGraph::addDependency(u32 before, u32 after) {
+        if (built || before >= after || after >= taskCount) {
+            FR_LOG_ERROR(TASK, "Invalid dependency from %u to %u", before, after);
+            return;
+        }
+        explicitPredecessors[after] |= (TaskMask)1 << before;
+    }
+
+    bool TaskGraph::build() {
+        if (built || !taskCount) return false;
+
+        // Every edge goes from an earlier task to a later one, so declaration order is already a
+        // topological order and walking backwards visits successors first.
+        TaskMask edges[TASK_MAX_COUNT] {};
+        TaskMask reach[TASK_MAX_COUNT] {};
+        for (u32 i = 0; i < taskCount; i++)
+            for (u32 j = 0; j < i; j++)
+                if (explicitPredecessors[i] >> j & 1
+                    || conflicts(tasks[j].reads, tasks[j].writes, tasks[i].reads, tasks[i].writes))
+                    edges[j] |= (TaskMask)1 << i;
+        for (u32 i = taskCount; i-- > 0;) {
+            TaskMask implied = 0;
+            for (TaskMask bits = edges[i]; bits; bits &= bits - 1)
+                implied |= reach[__builtin_ctzll(bits)];
+            successors[i] = edges[i] & ~implied;
+            reach[i]      = edges[i] | implied;
+        }
+
+        // Task i of frame N before task k of frame N+1. An edge is redundant when a later task
+        // of frame N already waits for i and carries the edge, or when k already waits for an
+        // earlier task of frame N+1 that carries it.
+        TaskMask next[TASK_MAX_COUNT] {};
+        for (u32 i = 0; i < taskCount; i++)
+            for (u32 k = 0; k < taskCount; k++)
+                if (i == k
+                    || conflicts(tasks[i].reads, tasks[i].writes, tasks[k].reads, tasks[k].writes))
+                    next[i] |= (TaskMask)1 << k;
+        for (u32 i = 0; i < taskCount; i++) {
+            TaskMask kept = next[i];
+            for (TaskMask bits = next[i]; bits; bits &= bits - 1) {
+                const u32 k         = __builtin_ctzll(bits);
+                bool      redundant = false;
+                for (TaskMask later = reach[i]; later && !redundant; later &= later - 1)
+                    redundant = next[__builtin_ctzll(later)] >> k & 1;
+                for (TaskMask other = next[i] & ~((TaskMask)1 << k); other && !redundant;
+                    other &= other - 1)
+                    redundant = reach[__builtin_ctzll(other)] >> k & 1;
+                if (redundant) kept &= ~((TaskMask)1 << k);
+            }
+            nextSuccessors[i] = kept;
+        }
+
+        for (u32 i = 0; i < taskCount; i++) {
+            for (TaskMask bits = successors[i]; bits; bits &= bits - 1)
+                predecessorCount[__builtin_ctzll(bits)]++;
+            for (TaskMask bits = nextSuccessors[i]; bits; bits &= bits - 1)
+                previousCount[__builtin_ctzll(bits)]++;
+            averageCost[i] = 1;
+        }
+        updatePriorities();
+
+        built = true;
+        prepareSlot(0);
+        return true;
+    }
+
+    // Every count carries one extra reference that beginFrame() drops, so frame N can finish
+    // tasks that frame N+1 waits on before frame N+1 starts.
+    void TaskGraph::prepareSlot(u64 frame) {
+        FrameSlot* slot = &slots[frame % FRAME_SLOTS];
+        for (u32 i = 0; i < taskCount; i++)
+            slot->pending[i] = predecessorCount[i] + (frame ? previousCount[i] : 0) + 1;
+        slot->remaining.value = taskCount;
+        slot->frame           = frame;
+    }
+
+    void TaskGraph::beginFrame() {
+        if (!built) {
+            FR_LOG_ERROR(TASK, "Called beginFrame() before build()");
+            return;
+        }
+        const u64 frame = nextFrame++;
+        if (frame >= TASK_FRAMES_IN_FLIGHT) {
+            const u64 finished = frame - TASK_FRAMES_IN_FLIGHT;
+            jobs->wait(&slots[finished % FRAME_SLOTS].remaining);
+            collectTimings(finished + 1);
+        }
+        prepareSlot(frame + 1);
+
+        const u32  index = (u32)(frame % FRAME_SLOTS);
+        FrameSlot* slot  = &slots[index];
+        u32        ready[TASK_MAX_COUNT];
+        u32        count = 0;
+        for (u32 i = 0; i < taskCount; i++)
+            if (!__atomic_sub_fetch(&slot->pending[i], 1, __ATOMIC_ACQ_REL)) ready[count++] = i;
+        sortReady(ready, count);
+        launch(ready, count, index);
+    }
+
+    void TaskGraph::waitFrames() {
+        const u64 first = timedFrames;
+        for (u64 frame = first; frame < nextFrame; frame++)
+            jobs->wait(&slots[frame % FRAME_SLOTS].remaining);
+        collectTimings(nextFrame);
+    }
+
+    u64 TaskGraph::getFrame() const { return nextFrame; }
+    u32 TaskGraph::getTaskCount() const { return taskCount; }
+
+    // Sorts from least to most critical.
+    void TaskGraph::sortReady(u32* ready, u32 count) const {
+        for (u32 i = 1; i < count; i++) {
+            const u32 task = ready[i];
+            const u64 key  = __atomic_load_n(&priority[task], __ATOMIC_RELAXED);
+            u32       j    = i;
+            for (; j > 0 && __atomic_load_n(&priority[ready[j - 1]], __ATOMIC_RELAXED) > key; j--)
+                ready[j] = ready[j - 1];
+            ready[j] = task;
+        }
+    }
+    // Pushed in sorted order, so this worker pops the most critical task next while thieves
+    // take the rest from the other end.
+    void TaskGraph::launch(const u32* ready, u32 count, u32 slot) {
+        for (u32 i = 0; i < count; i++) {
+            const u32 task = ready[i];
+            jobs->run([this, task, slot] { runTask(task, slot); });
+        }
+    }
+
+    void TaskGraph::runTask(u32 task, u32 slot) {
+        FrameSlot* frame      = &slots[slot];
+        const u32  next_index = (slot + 1) % FRAME_SLOTS;
+        FrameSlot* next       = &slots[next_index];
+
+        while (task != TASK_NONE) {
+            frame->start[task] = getTime();
+            tasks[task].invoke(tasks[task].payload, frame->frame);
+            frame->end[task] = getTime();
+
+            u32 ready[TASK_MAX_COUNT];
+            u32 count = 0;
+            for (TaskMask bits = nextSuccessors[task]; bits; bits &= bits - 1) {
+                const u32 successor = __builtin_ctzll(bits);
+                if (!__atomic_sub_fetch(&next->pending[successor], 1, __ATOMIC_ACQ_REL))
+                    ready[count++] = successor;
+            }
+            sortReady(ready, count);
+            launch(ready, count, next_index);
+
+            count = 0;
+            for (TaskMask bits = successors[task]; bits; bits &= bits - 1) {
+                const u32 successor = __builtin_ctzll(bits);
+                if (!__atomic_sub_fetch(&frame->pending[successor], 1, __ATOMIC_ACQ_REL))
+                    ready[count++] = successor;
+            }
+            // The most critical successor runs right here instead of going through the deque.
+            sortReady(ready, count);
+            const u32 following = count ? ready[--count] : TASK_NONE;
+            launch(ready, count, slot);
+
+            __atomic_sub_fetch(&frame->remaining.value, 1, __ATOMIC_RELEASE);
+            task = following;
+        }
+    }
+
+    void TaskGraph::collectTimings(u64 until) {
+        if (timedFrames >= until) return;
+        for (; timedFrames < until; timedFrames++) {
+            const FrameSlot* slot  = &slots[timedFrames % FRAME_SLOTS];
+            u64              first = ~0ull, last = 0;
+            for (u32 i = 0; i < taskCount; i++) {
+                const u64 cost = slot->end[i] - slot->start[i];
+                lastCost[i]    = cost;
+                averageCost[i] = averageCost[i] + (cost >> TASK_AVERAGE_SHIFT)
+                               - (averageCost[i] >> TASK_AVERAGE_SHIFT);
+                if (slot->start[i] < first) first = slot->start[i];
+                if (slot->end[i] > last) last = slot->end[i];
+            }
+            lastFrameCost = last - first;
+        }
+        updatePriorities();
+    }
+
+    void TaskGraph::updatePriorities() {
+        criticalPath = 0;
+        for (u32 i = taskCount; i-- > 0;) {
+            u64 longest = 0;
+            for (TaskMask bits = successors[i]; bits; bits &= bits - 1) {
+                const u64 path = priority[__builtin_ctzll(bits)];
+                if (path > longest) longest = path;
+            }
+            __atomic_store_n(&priority[i], averageCost[i] + longest, __ATOMIC_RELAXED);
+            if (priority[i] > criticalPath) criticalPath = priority[i];
+            head[i] = 0;
+        }
+        for (u32 i = 0; i < taskCount; i++)
+            for (TaskMask bits = successors[i]; bits; bits &= bits - 1) {
+                const u32 successor = __builtin_ctzll(bits);
+                if (head[i] + averageCost[i] > head[successor])
+                    head[successor] = head[i] + averageCost[i];
+            }
+    }
+
+    TaskTiming TaskGraph::getTiming(u32 task) const {
+        if (task >= taskCount) return {};
+        return {
+            .name      = tasks[task].name,
+            .lastMs    = (f64)lastCost[task] * 1e-6,
+            .averageMs = (f64)averageCost[task] * 1e-6,
+            .slackMs   = (f64)(criticalPath - head[task] - priority[task]) * 1e-6,
+        };
+    }
+    f64 TaskGraph::getCriticalPathMs() const { return (f64)criticalPath * 1e-6; }
+
+    void TaskGraph::logTimings() const {
+        FR_LOG_INFO(
+            TASK,
+            "Frame %llu took %.3f ms, critical path %.3f ms",
+            (unsigned long long)timedFrames,
+            (f64)lastFrameCost * 1e-6,
+            getCriticalPathMs());
+        for (u32 i = 0; i < taskCount; i++) {
+            const TaskTiming timing = getTiming(i);
+            FR_LOG_INFO(
+                TASK,
+                "  %-24s %8.3f ms  avg %8.3f ms  slack %8.3f ms%s",
+                timing.name,
+                timing.lastMs,
+                timing.averageMs,
+                timing.slackMs,
+                timing.slackMs == 0 ? "  critical" : "");
+        }
+    }
+}
@@ -0,0 +1,541 @@
+#include <string.h>
+
+#include <FrogEngine/Atomic.h>
+#include <FrogEngine/Clock.h>
+#include <FrogEngine/Format.h>
+#include <FrogEngine/Hash.h>
+#include <FrogEngine/Log.h>
+#include <FrogEngine/LogFile.h>
+#include <FrogEngine/Ring.h>
+#include <FrogEngine/Runtime.h>
+#include <FrogEngine/Thread.h>
+#include <FrogEngine/Utility.h>
+
+#ifdef FR_OS_WINDOWS
+#    include <windows.h>
+#endif
+
+#include <new>
+
+namespace FrogEngine {
+    // Threads past the first LOG_MAX_THREADS that log write their lines synchronously.
+    constexpr u32   LOG_MAX_THREADS { 32 };
+    constexpr usize LOG_RING_SIZE { 65'536 };
+    // Captured arguments of one message, including copies of its strings.
+    constexpr usize LOG_ARGUMENT_SIZE { 512 };
+    constexpr usize LOG_BATCH_SIZE { 16'384 };
+    // The logger polls quickly while messages arrive and backs off to the longer sleep when idle.
+    constexpr u64 LOG_ACTIVE_SLEEP { 1 * NANOSECONDS_PER_MILLISECOND };
+    constexpr u64 LOG_IDLE_SLEEP { 8 * NANOSECONDS_PER_MILLISECOND };
+    // Twice the sites a log file holds, so lookups stay short.
+    constexpr u32 LOG_SITE_SLOTS { LOG_FILE_MAX_SITES * 2 };
+    // A packed record is at most 13 bytes of header plus its arguments, which pack smaller than
+    // LOG_ARGUMENT_SIZE, or a formatted line.
+    constexpr usize LOG_PACKED_SIZE { 16 + LOG_LINE_SIZE };
+
+    enum LoggerState : u32 { LOGGER_IDLE, LOGGER_STARTING, LOGGER_RUNNING, LOGGER_STOPPED };
+
+    enum RecordKind : u8 {
+        RECORD_PADDING,  ///< Skips the rest of the ring up to the wrap
+        RECORD_CAPTURED, ///< Arguments laid out by captureFormat()
+        RECORD_TEXT,     ///< Message formatted by the caller, when its arguments did not fit
+    };
+
+    // Records start 8 byte aligned, so the size and kind of a padding record fit in the last 8
+    // bytes before the wrap. `time` is only taken while a log file is open.
+    struct LogRecord {
+        u32         size;
+        LogLevel    level;
+        RecordKind  kind;
+        LogChannel  channel;
+        const char* format;
+        u64         time;
+    };
+
+    typedef Ring<u8, LOG_RING_SIZE>                     LogRing;
+    typedef RingSet<u8, LOG_RING_SIZE, LOG_MAX_THREADS> LogRings;
+
+    struct LogBatch {
+        FileHandle file;
+        usize      length;
+        char       data[LOG_BATCH_SIZE];
+    };
+
+    // The open log file. `block` is the one being filled and `time` that of the last record.
+    struct LogFileWriter {
+        LogFileHeader* header;
+        usize          size;
+        u8*            blocks;
+        LogFileBlock*  block;
+        u64            sequence;
+        u64            time;
+    };
+
+    struct LogSite {
+        const char* format;
+        u32         tag; ///< Level and channel, like the text sites
+        u32         id;
+    };
+
+    static const char* const LEVEL_PREFIX[] {
+        FR_LOG_FORMAT_BRIGHT_BLACK "[TRACE] " FR_LOG_FORMAT_RESET,
+        FR_LOG_FORMAT_GREEN "[INFO] " FR_LOG_FORMAT_RESET,
+        FR_LOG_FORMAT_BRIGHT_YELLOW "[WARNING] " FR_LOG_FORMAT_RESET,
+    };
+    // Index into `batches` by level, one batch per output file.
+    static const u32  LEVEL_BATCH[] { 0, 0, 1 };
+    static const char LINE_SUFFIX[] { FR_LOG_FORMAT_RESET "\n" };
+    static const char ERROR_STYLE[] {
+        FR_LOG_FORMAT_BRIGHT_RED FR_LOG_FORMAT_BOLD FR_LOG_FORMAT_ITALIC
+    };
+    static constexpr char DROPPED_FORMAT[] {
+        "Dropped %llu messages, the ring of a thread was full"
+    };
+    static constexpr char TEXT_FORMAT[] { "%s" };
+
+    struct ChannelStyle {
+        const char* name;
+        const char* color;
+    };
+    static const ChannelStyle CHANNEL_STYLES[] {
+        { "", "" },
+        { "ALLOCATOR", FR_LOG_FORMAT_YELLOW },
+        { "SAVE", FR_LOG_FORMAT_BRIGHT_GREEN },
+        { "WINDOW", FR_LOG_FORMAT_BLUE },
+        { "STRING", FR_LOG_FORMAT_MAGENTA },
+        { "ENTITY", FR_LOG_FORMAT_GREEN },
+        { "JOB", FR_LOG_FORMAT_BRIGHT_BLUE },
+        { "TASK", FR_LOG_FORMAT_BRIGHT_BLUE },
+        { "LOG", FR_LOG_FORMAT_BRIGHT_CYAN },
+    };
+    static const char* const USER_NAMES[] {
+        "USER0", "USER1", "USER2", "USER3", "USER4", "USER5", "USER6",
+    };
+    static_assert(
+        sizeof(CHANNEL_STYLES) / sizeof(*CHANNEL_STYLES) == CHANNEL_USER,
+        "Every channel needs a style");
+    static_assert(
+        sizeof(USER_NAMES) / sizeof(*USER_NAMES) == LOG_CHANNEL_COUNT - CHANNEL_USER,
+        "Every channel needs a name");
+
+    constexpr u8 LOG_DEFAULT_MASK { (u8)(0xFF << LOG_INFO) };
+
+    u8 logChannelMasks[LOG_CHANNEL_COUNT] {
+        LOG_DEFAULT_MASK, LOG_DEFAULT_MASK, LOG_DEFAULT_MASK, LOG_DEFAULT_MASK,
+        LOG_DEFAULT_MASK, LOG_DEFAULT_MASK, LOG_DEFAULT_MASK, LOG_DEFAULT_MASK,
+        LOG_DEFAULT_MASK, LOG_DEFAULT_MASK, LOG_DEFAULT_MASK, LOG_DEFAULT_MASK,
+        LOG_DEFAULT_MASK, LOG_DEFAULT_MASK, LOG_DEFAULT_MASK, LOG_DEFAULT_MASK,
+    };
+
+    static LogRings rings;
+    static u32      loggerState;
+    // Whoever holds it is the single consumer of every ring.
+    static SpinLock drainLock;
+    static LogBatch batches[2];
+    alignas(Thread) static u8 loggerStorage[sizeof(Thread)];
+    // Only touched under drainLock. `fileOpen` tells producers to take timestamps.
+    static LogFileWriter fileWriter;
+    static LogSite       sites[LOG_SITE_SLOTS];
+    static u32           fileOpen;
+
+    void setLogLevel(LogChannel channel, LogLevel minimum) {
+        if (channel < LOG_CHANNEL_COUNT)
+            __atomic_store_n(&logChannelMasks[channel], (u8)(0xFF << minimum), __ATOMIC_RELAXED);
+    }
+
+    const char* getChannelName(LogChannel channel) {
+        if (channel < CHANNEL_USER) return CHANNEL_STYLES[channel].name;
+        if (channel < LOG_CHANNEL_COUNT) return USER_NAMES[channel - CHANNEL_USER];
+        return "UNKNOWN";
+    }
+
+    // Level and channel, like "[INFO] ALLOCATOR: ". Returns its length.
+    static usize formatPrefix(char* line, LogLevel level, LogChannel channel) {
+        if (channel == CHANNEL_GENERAL)
+            return formatString(line, LOG_LINE_SIZE, "%s", LEVEL_PREFIX[level]);
+        return formatString(
+            line,
+            LOG_LINE_SIZE,
+            "%s%s%s%s: ",
+            LEVEL_PREFIX[level],
+            channel < CHANNEL_USER ? CHANNEL_STYLES[channel].color : FR_LOG_FORMAT_WHITE,
+            getChannelName(channel),
+            FR_LOG_FORMAT_RESET);
+    }
+
+    static void writeBatch(LogBatch* batch) {
+        if (batch->length) writeFile(batch->file, batch->data, batch->length);
+        batch->length = 0;
+    }
+
+    // Lines are cut short so the suffix always fits, like formatLogLine().
+    static void appendRecord(const LogRecord* record) {
+        LogBatch* batch = &batches[LEVEL_BATCH[record->level]];
+        if (batch->length + LOG_LINE_SIZE > LOG_BATCH_SIZE) writeBatch(batch);
+
+        char*     line     = batch->data + batch->length;
+        const u8* payload  = (const u8*)(record + 1);
+        usize     length   = formatPrefix(line, record->level, record->channel);
+        const i32 capacity = (i32)(LOG_LINE_SIZE - length - LOG_SUFFIX_SIZE);
+        const i32 message  = record->kind == RECORD_CAPTURED
+                               ? formatCaptured(line + length, capacity, record->format, payload)
+                               : formatString(line + length, capacity, "%s", (const char*)payload);
+        length            += message < capacity ? message : capacity - 1;
+        length            += formatString(line + length, LOG_LINE_SIZE - length, "%s", LINE_SUFFIX);
+        batch->length     += length;
+    }
+
+    // Index of the site in the file's table, adding it on first use. Once the table is full
+    // this is the text site of the level and channel, and the message is stored formatted.
+    static u32 findSite(const char* format, LogLevel level, LogChannel channel) {
+        const u32 tag  = level * LOG_CHANNEL_COUNT + channel;
+        u32       slot = (u32)mixHash((uptr)format << 6 | tag) & (LOG_SITE_SLOTS - 1);
+        for (; sites[slot].format; slot = (slot + 1) & (LOG_SITE_SLOTS - 1))
+            if (sites[slot].format == format && sites[slot].tag == tag) return sites[slot].id;
+
+        LogFileHeader* header = fileWriter.header;
+        LogFileTable*  table  = (LogFileTable*)((u8*)header + LOG_FILE_HEADER_SIZE);
+        const usize    length = strlen(format) + 1;
+        const u32      offset = sizeof(LogFileTable) + header->tableUsed;
+        if (header->siteCount == LOG_FILE_MAX_SITES || length + 2 > header->tableSize - offset)
+            return tag;
+
+        u8* site = (u8*)table + offset;
+        site[0]  = level;
+        site[1]  = channel;
+        __builtin_memcpy(site + 2, format, length);
+        table->offsets[header->siteCount] = offset;
+        sites[slot]                       = { format, tag, header->siteCount };
+        __atomic_store_n(&header->tableUsed, header->tableUsed + (u32)length + 2, __ATOMIC_RELEASE);
+        __atomic_store_n(&header->siteCount, header->siteCount + 1, __ATOMIC_RELEASE);
+        return sites[slot].id;
+    }
+
+    // Moves on to the next block of the ring, overwriting the oldest once it wraps.
+    static void startBlock() {
+        const u64     sequence = ++fileWriter.sequence;
+        const u64     index    = (sequence - 1) % fileWriter.header->blockCount;
+        LogFileBlock* block    = (LogFileBlock*)(fileWriter.blocks + index * LOG_FILE_BLOCK_SIZE);
+        // Readers skip the block while it is reset.
+        __atomic_store_n(&block->sequence, 0, __ATOMIC_RELEASE);
+        __atomic_store_n(&block->used, 0, __ATOMIC_RELEASE);
+        block->time = fileWriter.time;
+        __atomic_store_n(&block->sequence, sequence, __ATOMIC_RELEASE);
+        fileWriter.block = block;
+    }
+
+    static u8* packArguments(u8* cursor, const char* format, const u8* payload) {
+        FormatArgument kinds[LOG_ARGUMENT_SIZE / 8];
+        const u32      count = getFormatArguments(format, kinds, LOG_ARGUMENT_SIZE / 8);
+        for (u32 i = 0; i < count && i < LOG_ARGUMENT_SIZE / 8; i++) {
+            u64 value;
+            __builtin_memcpy(&value, payload, sizeof(value));
+            payload += sizeof(value);
+            switch (kinds[i]) {
+                case ARGUMENT_INT: cursor = writeVarint(cursor, encodeZigzag((i64)value)); break;
+                case ARGUMENT_FLOAT:
+                    __builtin_memcpy(cursor, &value, sizeof(value));
+                    cursor += sizeof(value);
+                    break;
+                case ARGUMENT_TEXT:
+                    if (value == CAPTURE_NULL_TEXT) {
+                        *cursor++ = 0;
+                        break;
+                    }
+                    cursor = writeVarint(cursor, value + 1);
+                    __builtin_memcpy(cursor, payload, value);
+                    cursor  += value;
+                    payload += (value + 8) & ~7ull;
+                    break;
+                default: cursor = writeVarint(cursor, value);
+            }
+        }
+        return cursor;
+    }
+
+    // Packs a record into the current block, see LogFileBlock for the layout.
+    static void appendFileRecord(const LogRecord* record, const u8* payload, u8 thread) {
+        const u64 time = record->time ? record->time : getTime();
+        u32       site = record->level * LOG_CHANNEL_COUNT + record->channel;
+        char      text[LOG_LINE_SIZE];
+        if (record->kind == RECORD_CAPTURED) {
+            site = findSite(record->format, record->level, record->channel);
+            if (site < LOG_FILE_TEXT_SITES) {
+                formatCaptured(text, sizeof(text), record->format, payload);
+                payload = (const u8*)text;
+            }
+        }
+
+        u8  packed[LOG_PACKED_SIZE];
+        u8* cursor = writeVarint(packed, site);
+        cursor     = writeVarint(cursor, encodeZigzag((i64)(time - fileWriter.time)));
+        *cursor++  = thread;
+        if (site < LOG_FILE_TEXT_SITES) {
+            const usize length = strlen((const char*)payload);
+            cursor             = writeVarint(cursor, length + 1);
+            __builtin_memcpy(cursor, payload, length);
+            cursor += length;
+        } else {
+            cursor = packArguments(cursor, record->format, payload);
+        }
+
+        // A new block starts from the time of the last record, so the delta still holds.
+        const u32 size = (u32)(cursor - packed);
+        if (fileWriter.block->used + size > LOG_FILE_BLOCK_SIZE - sizeof(LogFileBlock))
+            startBlock();
+        LogFileBlock* block = fileWriter.block;
+        __builtin_memcpy((u8*)(block + 1) + block->used, packed, size);
+        __atomic_store_n(&block->used, block->used + size, __ATOMIC_RELEASE);
+        fileWriter.time = time;
+    }
+
+    // Stores a message that did not come through a ring.
+    static void appendFileLine(
+        LogLevel level, LogChannel channel, u8 thread, const char* format, va_list args) {
+        u8        payload[LOG_LINE_SIZE];
+        LogRecord record {
+            .level   = level,
+            .kind    = RECORD_CAPTURED,
+            .channel = channel,
+            .format  = format,
+            .time    = getTime(),
+        };
+        if (captureFormat(payload, LOG_ARGUMENT_SIZE, format, args) < 0) {
+            formatString((char*)payload, sizeof(payload), format, args);
+            record.kind = RECORD_TEXT;
+        }
+        appendFileRecord(&record, payload, thread);
+    }
+    static void appendFileMessage(
+        LogLevel level, LogChannel channel, u8 thread, const char* format, ...) {
+        va_list args;
+        va_start(args, format);
+        appendFileLine(level, channel, thread, format, args);
+        va_end(args);
+    }
+
+    static bool drainRing(LogRing* ring) {
+        const u64 head = ring->getPublished();
+        u64       tail = ring->getConsumed();
+        if (tail == head && !ring->hasDropped()) return false;
+
+        const u8 thread = (u8)rings.getIndex(ring);
+        while (tail != head) {
+            const LogRecord* record = (const LogRecord*)&(*ring)[tail];
+            if (record->kind != RECORD_PADDING) {
+                if (fileWriter.header) appendFileRecord(record, (const u8*)(record + 1), thread);
+                else appendRecord(record);
+            }
+            tail += record->size;
+        }
+        ring->consume(tail);
+
+        if (ring->hasDropped()) {
+            const unsigned long long count = ring->takeDropped();
+            if (fileWriter.header) {
+                appendFileMessage(LOG_WARNING, CHANNEL_LOG, thread, DROPPED_FORMAT, count);
+                return true;
+            }
+            LogBatch* batch = &batches[LEVEL_BATCH[LOG_WARNING]];
+            if (batch->length + LOG_LINE_SIZE > LOG_BATCH_SIZE) writeBatch(batch);
+            char* line     = batch->data + batch->length;
+            usize length   = formatPrefix(line, LOG_WARNING, CHANNEL_LOG);
+            length        += formatString(
+                line + length, LOG_LINE_SIZE - length, DROPPED_FORMAT, count);
+            length        += formatString(line + length, LOG_LINE_SIZE - length, "%s", LINE_SUFFIX);
+            batch->length += length;
+        }
+        return true;
+    }
+
+    static bool drainRings() {
+        SpinGuard guard(&drainLock);
+        batches[0].file = FILE_OUTPUT;
+        batches[1].file = FILE_ERROR;
+
+        const u32 count   = rings.getCount();
+        bool      drained = false;
+        for (u32 i = 0; i < count; i++) drained |= drainRing(rings.getRing(i));
+        writeBatch(&batches[0]);
+        writeBatch(&batches[1]);
+        return drained;
+    }
+
+    static void runLogger(ptr) {
+        u64 sleep = LOG_ACTIVE_SLEEP;
+        while (__atomic_load_n(&loggerState, __ATOMIC_ACQUIRE) == LOGGER_RUNNING) {
+            if (drainRings()) sleep = LOG_ACTIVE_SLEEP;
+            else if (sleep < LOG_IDLE_SLEEP) sleep *= 2;
+            sleepFor(sleep);
+        }
+    }
+
+    static void startLogger() {
+        u32 expected = LOGGER_IDLE;
+        if (!__atomic_compare_exchange_n(
+                &loggerState,
+                &expected,
+                LOGGER_STARTING,
+                false,
+                __ATOMIC_ACQ_REL,
+                __ATOMIC_RELAXED))
+            return;
+
+        // The logger only formats into the static batches, so a small stack does.
+        Thread* thread = new (loggerStorage) Thread();
+        __atomic_store_n(&loggerState, LOGGER_RUNNING, __ATOMIC_RELEASE);
+        if (!thread->start(runLogger, nullptr, THREAD_STACK_SIZE / 4))
+            __atomic_store_n(&loggerState, LOGGER_STOPPED, __ATOMIC_RELEASE);
+    }
+
+    // Stores a message in the log file right away. Returns false when none is open.
+    static bool writeFileLine(
+        LogLevel level, LogChannel channel, const char* format, va_list args) {
+        if (!__atomic_load_n(&fileOpen, __ATOMIC_ACQUIRE)) return false;
+        LogRing*  ring   = rings.claim();
+        const u8  thread = ring ? (u8)rings.getIndex(ring) : LOG_FILE_NO_THREAD;
+        SpinGuard guard(&drainLock);
+        if (!fileWriter.header) return false;
+        appendFileLine(level, channel, thread, format, args);
+        return true;
+    }
+
+    static void writeLine(LogLevel level, LogChannel channel, const char* format, va_list args) {
+        if (writeFileLine(level, channel, format, args)) return;
+
+        char prefix[LOG_LINE_SIZE];
+        char line[LOG_LINE_SIZE];
+        formatPrefix(prefix, level, channel);
+        const usize length = formatLogLine(line, prefix, LINE_SUFFIX, format, args);
+        writeFile(LEVEL_BATCH[level] ? FILE_ERROR : FILE_OUTPUT, line, length);
+    }
+
+    void writeLog(LogLevel level, LogChannel channel, const char* format, va_list args) {
+        LogRing*  ring  = rings.claim();
+        const u32 state = __atomic_load_n(&loggerState, __ATOMIC_ACQUIRE);
+        if (!ring || state == LOGGER_STOPPED) {
+            writeLine(level, channel, format, args);
+            return;
+        }
+        if (state == LOGGER_IDLE) startLogger();
+
+        const u64  time = __atomic_load_n(&fileOpen, __ATOMIC_RELAXED) ? getTime() : 0;
+        u8         payload[LOG_ARGUMENT_SIZE];
+        RecordKind kind = RECORD_CAPTURED;
+        i64        size = captureFormat(payload, sizeof(payload), format, args);
+        if (size < 0) {
+            const i32 length = formatString((char*)payload, sizeof(payload), format, args);
+            kind             = RECORD_TEXT;
+            size             = (length < (i32)sizeof(payload) ? length : sizeof(payload) - 1) + 1;
+        }
+
+        // A record that would cross the end of the ring starts over at the beginning instead.
+        const u64 record_size = (sizeof(LogRecord) + size + 7) & ~7ull;
+        const u64 head        = ring->getHead();
+        const u64 tail        = ring->getTail();
+        const u64 contiguous  = LOG_RING_SIZE - head % LOG_RING_SIZE;
+        const u64 padding     = record_size > contiguous ? contiguous : 0;
+        if (head + padding + record_size - tail > LOG_RING_SIZE) {
+            ring->drop();
+            return;
+        }
+        if (padding) {
+            LogRecord* skip = (LogRecord*)&(*ring)[head];
+            skip->size      = (u32)padding;
+            skip->kind      = RECORD_PADDING;
+        }
+
+        LogRecord* record = (LogRecord*)&(*ring)[head + padding];
+        record->size      = (u32)record_size;
+        record->level     = level;
+        record->kind      = kind;
+        record->channel   = channel;
+        record->format    = format;
+        record->time      = time;
+        __builtin_memcpy(record + 1, payload, size);
+        ring->publish(head + padding + record_size);
+    }
+
+    void flushLog() { drainRings(); }
+
+    bool openLogFile(const char* path, usize _size) {
+        closeLogFile();
+        const usize blocks = LOG_FILE_HEADER_SIZE + LOG_FILE_TABLE_SIZE;
+        if (_size < blocks + 2 * LOG_FILE_BLOCK_SIZE) return false;
+        u64 block_count = (_size - blocks) / LOG_FILE_BLOCK_SIZE;
+        if (block_count > ~0u) block_count = ~0u;
+        const usize file_size = blocks + block_count * LOG_FILE_BLOCK_SIZE;
+        u8*         file      = (u8*)mapFile(path, file_size);
+        if (!file) return false;
+
+        SpinGuard      guard(&drainLock);
+        LogFileHeader* header = (LogFileHeader*)file;
+        header->version       = LOG_FILE_VERSION;
+        header->blockSize     = LOG_FILE_BLOCK_SIZE;
+        header->blockCount    = (u32)block_count;
+        header->tableSize     = LOG_FILE_TABLE_SIZE;
+        header->startTime     = getTime();
+        fileWriter            = {};
+        fileWriter.header     = header;
+        fileWriter.size       = file_size;
+        fileWriter.blocks     = file + blocks;
+        fileWriter.time       = header->startTime;
+        __builtin_memset(sites, 0, sizeof(sites));
+        for (u32 level = LOG_TRACE; level <= LOG_ERROR; level++)
+            for (u32 channel = 0; channel < LOG_CHANNEL_COUNT; channel++)
+                findSite(TEXT_FORMAT, (LogLevel)level, (LogChannel)channel);
+        startBlock();
+        // Readers check the magic before anything else.
+        __atomic_store_n(&header->magic, LOG_FILE_MAGIC, __ATOMIC_RELEASE);
+        __atomic_store_n(&fileOpen, 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    void closeLogFile() {
+        flushLog();
+        SpinGuard guard(&drainLock);
+        if (!fileWriter.header) return;
+        __atomic_store_n(&fileOpen, 0, __ATOMIC_RELAXED);
+        unmapFile(fileWriter.header, fileWriter.size);
+        fileWriter = {};
+    }
+
+    void writeError(LogChannel channel, const char* format, va_list args) {
+        // Whatever was queued before the error goes out first, and the error goes to the log
+        // file as well as the terminal.
+        flushLog();
+        va_list copy;
+        va_copy(copy, args);
+        writeFileLine(LOG_ERROR, channel, format, copy);
+        va_end(copy);
+
+        char prefix[LOG_LINE_SIZE];
+        char line[LOG_LINE_SIZE];
+        formatString(
+            prefix,
+            sizeof(prefix),
+            "%s[ERROR] %s%s",
+            ERROR_STYLE,
+            getChannelName(channel),
+            channel == CHANNEL_GENERAL ? "" : ": ");
+        const usize length = formatLogLine(line, prefix, LINE_SUFFIX, format, args);
+        writeFile(FILE_OUTPUT, line, length);
+#ifdef FR_OS_WINDOWS
+        // The message box gets the line without the terminal styling.
+        line[length - sizeof(LINE_SUFFIX) + 1] = '\0';
+        MessageBoxA(nullptr, line + sizeof(ERROR_STYLE) - 1, "Error", MB_OK | MB_ICONERROR);
+#endif
+        exit(-1);
+    }
+
+    // Runs after the destructors of static objects, so whatever they logged still goes out.
+    // Anything logged later is written synchronously.
+    __attribute__((destructor)) static void stopLogger() {
+        if (__atomic_exchange_n(&loggerState, LOGGER_STOPPED, __ATOMIC_ACQ_REL) == LOGGER_RUNNING) {
+            Thread* thread = (Thread*)loggerStorage;
+            thread->join();
+            thread->~Thread();
+        }
+        drainRings();
+    }
+}
@@ -0,0 +1,137 @@
+#include <FrogEngine/LogFile.h>
+#include <FrogEngine/Runtime.h>
+#include <FrogEngine/Utility.h>
+
+namespace FrogEngine {
+    // Arguments a record can hold, one slot each in LOG_FILE_ARGUMENT_SIZE.
+    constexpr u32 LOG_FILE_MAX_ARGUMENTS { LOG_FILE_ARGUMENT_SIZE / 8 };
+
+    struct LogReader {
+        const LogFileHeader* header;
+        const char*          table;
+        u64                  start;
+        LogVisitor           visit;
+        ptr                  user;
+    };
+
+    // Level, channel and format of a site. Returns false when it is out of the table or not
+    // terminated inside it.
+    static bool findSite(const LogReader* reader, u64 site, LogEntry* entry) {
+        if (site >= reader->header->siteCount || site >= LOG_FILE_MAX_SITES) return false;
+        const u32 offset = ((const LogFileTable*)reader->table)->offsets[site];
+        const u32 end    = sizeof(LogFileTable) + reader->header->tableUsed;
+        if (offset < sizeof(LogFileTable) || offset >= end || end - offset < 3) return false;
+
+        entry->level   = (LogLevel)reader->table[offset];
+        entry->channel = (LogChannel)reader->table[offset + 1];
+        entry->format  = reader->table + offset + 2;
+        if (entry->level > LOG_ERROR || entry->channel >= LOG_CHANNEL_COUNT) return false;
+        for (u32 i = offset + 2; i < end; i++)
+            if (!reader->table[i]) return true;
+        return false;
+    }
+
+    // Turns the packed arguments back into 8 byte slots. Returns false when they run past `end`
+    // or do not fit `arguments`.
+    static bool unpackArguments(
+        const u8** cursor, const u8* end, const char* format, u8* arguments) {
+        FormatArgument kinds[LOG_FILE_MAX_ARGUMENTS];
+        const u32      count = getFormatArguments(format, kinds, LOG_FILE_MAX_ARGUMENTS);
+        if (count > LOG_FILE_MAX_ARGUMENTS) return false;
+
+        u8* const limit = arguments + LOG_FILE_ARGUMENT_SIZE;
+        for (u32 i = 0; i < count; i++) {
+            u64 value;
+            if (kinds[i] == ARGUMENT_FLOAT) {
+                if (end - *cursor < 8) return false;
+                __builtin_memcpy(&value, *cursor, sizeof(value));
+                *cursor += sizeof(value);
+            } else if (!readVarint(cursor, end, &value)) {
+                return false;
+            }
+            if (limit - arguments < 8) return false;
+
+            if (kinds[i] == ARGUMENT_INT) value = (u64)decodeZigzag(value);
+            if (kinds[i] != ARGUMENT_TEXT || !value) {
+                if (kinds[i] == ARGUMENT_TEXT) value = CAPTURE_NULL_TEXT;
+                __builtin_memcpy(arguments, &value, sizeof(value));
+                arguments += sizeof(value);
+                continue;
+            }
+
+            const u64 length = value - 1;
+            const u64 padded = (length + 8) & ~7ull;
+            if ((u64)(end - *cursor) < length || (u64)(limit - arguments) < 8 + padded)
+                return false;
+            __builtin_memcpy(arguments, &length, sizeof(length));
+            __builtin_memcpy(arguments + 8, *cursor, length);
+            __builtin_memset(arguments + 8 + length, 0, padded - length);
+            *cursor   += length;
+            arguments += 8 + padded;
+        }
+        return true;
+    }
+
+    static void readBlock(const LogReader* reader, const LogFileBlock* block) {
+        const u32 capacity = reader->header->blockSize - sizeof(LogFileBlock);
+        const u32 used     = __atomic_load_n(&block->used, __ATOMIC_ACQUIRE);
+        const u8* cursor   = (const u8*)(block + 1);
+        const u8* end      = cursor + (used < capacity ? used : capacity);
+        u64       time     = block->time;
+
+        u8 arguments[LOG_FILE_ARGUMENT_SIZE];
+        while (cursor < end) {
+            LogEntry entry {};
+            u64      site, delta;
+            if (!readVarint(&cursor, end, &site) || !findSite(reader, site, &entry)) return;
+            if (!readVarint(&cursor, end, &delta) || cursor == end) return;
+            entry.thread = *cursor++;
+            if (!unpackArguments(&cursor, end, entry.format, arguments)) return;
+
+            time           += (u64)decodeZigzag(delta);
+            entry.time       = time - reader->start;
+            entry.arguments  = arguments;
+            reader->visit(&entry, reader->user);
+        }
+    }
+
+    bool readLogFile(const u8* file, usize _size, LogVisitor visit, ptr user) {
+        const LogFileHeader* header = (const LogFileHeader*)file;
+        if (_size < LOG_FILE_HEADER_SIZE || header->magic != LOG_FILE_MAGIC
+            || header->version != LOG_FILE_VERSION)
+            return false;
+        if (header->blockSize <= sizeof(LogFileBlock) || header->blockSize % 8
+            || header->tableSize < sizeof(LogFileTable)
+            || header->tableUsed > header->tableSize - sizeof(LogFileTable))
+            return false;
+        const usize blocks = LOG_FILE_HEADER_SIZE + header->tableSize;
+        if (_size < blocks || (_size - blocks) / header->blockSize < header->blockCount)
+            return false;
+
+        const LogReader reader {
+            .header = header,
+            .table  = (const char*)file + LOG_FILE_HEADER_SIZE,
+            .start  = header->startTime,
+            .visit  = visit,
+            .user   = user,
+        };
+        const auto getBlock = [&](u64 index) {
+            return (const LogFileBlock*)(file + blocks + index * header->blockSize);
+        };
+
+        // Blocks are written in sequence around the ring, so the newest one tells which are
+        // still in the file.
+        u64 newest = 0;
+        for (u64 i = 0; i < header->blockCount; i++) {
+            const u64 sequence = __atomic_load_n(&getBlock(i)->sequence, __ATOMIC_ACQUIRE);
+            if (sequence > newest) newest = sequence;
+        }
+        const u64 oldest = newest > header->blockCount ? newest - header->blockCount + 1 : 1;
+        for (u64 sequence = oldest; sequence <= newest; sequence++) {
+            const LogFileBlock* block = getBlock((sequence - 1) % header->blockCount);
+            if (__atomic_load_n(&block->sequence, __ATOMIC_ACQUIRE) == sequence)
+                readBlock(&reader, block);
+        }
+        return true;
+    }
+}
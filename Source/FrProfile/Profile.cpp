@@ -0,0 +1,180 @@
+#include <FrogEngine/Atomic.h>
+#include <FrogEngine/Clock.h>
+#include <FrogEngine/Format.h>
+#include <FrogEngine/Profile.h>
+#include <FrogEngine/Ring.h>
+#include <FrogEngine/Runtime.h>
+#include <FrogEngine/Utility.h>
+
+namespace FrogEngine {
+    constexpr usize PROFILE_BATCH_SIZE { 65'536 };
+    // Names are cut to this many characters in the trace.
+    constexpr usize PROFILE_NAME_SIZE { 256 };
+    // Room a single event needs in the batch, with every character of its name escaped.
+    constexpr usize PROFILE_EVENT_SIZE { PROFILE_NAME_SIZE * 2 + 256 };
+
+    struct ProfileZone {
+        const char* name;
+        u64         begin;
+        u64         end;
+    };
+
+    typedef Ring<ProfileZone, PROFILE_RING_SIZE>                         ProfileRing;
+    typedef RingSet<ProfileZone, PROFILE_RING_SIZE, PROFILE_MAX_THREADS> ProfileRings;
+
+    // The open trace. Events are timed in microseconds since `startCycles`.
+    struct ProfileWriter {
+        FileHandle file;
+        u64        startCycles;
+        u64        startTime;
+        f64        microsecondsPerCycle;
+        u64        frameBegin;
+        u64        events;
+        usize      length;
+        char       batch[PROFILE_BATCH_SIZE];
+    };
+
+    static ProfileRings rings;
+    // Held while the rings are written out, which makes the writer their consumer.
+    static SpinLock      writeLock;
+    static ProfileWriter writer { .file = FILE_NONE };
+    u32 profileOpen;
+
+    static void recordZone(const char* name, u64 begin, u64 end) {
+        ProfileRing* ring = rings.claim();
+        if (!ring) return;
+
+        const u64 head = ring->getHead();
+        if (head - ring->getTail() == PROFILE_RING_SIZE) {
+            ring->drop();
+            return;
+        }
+        (*ring)[head] = { name, begin, end };
+        ring->publish(head + 1);
+    }
+
+    void endProfileZone(const char* name, u64 begin) {
+        const u64 end = getCycles();
+        if (isProfiling()) recordZone(name, begin, end);
+    }
+
+    // The cycle counter's rate is only known by measuring it against the clock, over as long as
+    // the trace has run so far.
+    static void calibrate() {
+        const u64 cycles = getCycles() - writer.startCycles;
+        const u64 time   = getTime() - writer.startTime;
+        if (cycles) writer.microsecondsPerCycle = (f64)time / (f64)cycles * 1e-3;
+    }
+    static f64 getMicroseconds(u64 cycles) {
+        if (cycles < writer.startCycles) return 0;
+        return (f64)(cycles - writer.startCycles) * writer.microsecondsPerCycle;
+    }
+
+    static void writeBatch() {
+        writeFile(writer.file, writer.batch, writer.length);
+        writer.length = 0;
+    }
+    // Starts an event with its name, escaped for JSON.
+    static void beginEvent(const char* name) {
+        if (writer.length + PROFILE_EVENT_SIZE > PROFILE_BATCH_SIZE) writeBatch();
+        char* const start = writer.batch + writer.length;
+        char*       out   = start;
+        if (writer.events++) *out++ = ',';
+        for (const char* c = "\n{\"name\":\""; *c; c++) *out++ = *c;
+        for (usize i = 0; name[i] && i < PROFILE_NAME_SIZE; i++) {
+            if (name[i] == '"' || name[i] == '\\') *out++ = '\\';
+            *out++ = (u8)name[i] < 0x20 ? ' ' : name[i];
+        }
+        writer.length += out - start;
+    }
+
+    static void writeRing(ProfileRing* ring, u32 thread) {
+        const u64 head = ring->getPublished();
+        u64       tail = ring->getConsumed();
+        for (; tail != head; tail++) {
+            const ProfileZone &zone  = (*ring)[tail];
+            const f64          begin = getMicroseconds(zone.begin);
+            beginEvent(zone.name);
+            writer.length += formatString(
+                writer.batch + writer.length,
+                PROFILE_BATCH_SIZE - writer.length,
+                "\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+                begin,
+                getMicroseconds(zone.end) - begin,
+                thread);
+        }
+        ring->consume(tail);
+
+        // Drops show up as a marker on the thread's track.
+        if (!ring->hasDropped()) return;
+        beginEvent("Dropped zones, the ring was full");
+        writer.length += formatString(
+            writer.batch + writer.length,
+            PROFILE_BATCH_SIZE - writer.length,
+            "\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,"
+            "\"args\":{\"count\":%llu}}",
+            getMicroseconds(getCycles()),
+            thread,
+            (unsigned long long)ring->takeDropped());
+    }
+
+    // Moves every ring into the file. Threads keep ending zones meanwhile, the next frame picks
+    // those up.
+    static void writeZones() {
+        calibrate();
+        const u32 count = rings.getCount();
+        for (u32 i = 0; i < count; i++) writeRing(rings.getRing(i), i);
+        writeBatch();
+    }
+
+    void markProfileFrame() {
+        const u64 now = getCycles();
+        if (!__atomic_load_n(&profileOpen, __ATOMIC_ACQUIRE)) return;
+
+        SpinGuard guard(&writeLock);
+        if (writer.file == FILE_NONE) return;
+        if (writer.frameBegin) recordZone("Frame", writer.frameBegin, now);
+        writer.frameBegin = now;
+        writeZones();
+        // The cost of writing shows in the next frame's trace.
+        recordZone("Profile::write", now, getCycles());
+    }
+
+    static void finishFile() {
+        writeZones();
+        writeFile(writer.file, "\n]\n", 3);
+        closeFile(writer.file);
+        writer.file = FILE_NONE;
+    }
+
+    bool openProfileFile(const char* path) {
+        // A first estimate of the cycle rate, which every frame refines.
+        const u64 start_time   = getTime();
+        const u64 start_cycles = getCycles();
+        sleepFor(NANOSECONDS_PER_MILLISECOND);
+
+        const FileHandle file = openFile(path, FILE_WRITE);
+        if (file == FILE_NONE) return false;
+
+        SpinGuard guard(&writeLock);
+        if (writer.file != FILE_NONE) finishFile();
+        // Zones ended while no file was open are left out.
+        for (u32 i = 0; i < PROFILE_MAX_THREADS; i++) rings.getRing(i)->skip();
+        writer.file        = file;
+        writer.startTime   = start_time;
+        writer.startCycles = start_cycles;
+        writer.frameBegin  = 0;
+        writer.events      = 0;
+        writer.length      = 0;
+        calibrate();
+        writeFile(file, "[", 1);
+        __atomic_store_n(&profileOpen, 1u, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    void closeProfileFile() {
+        __atomic_store_n(&profileOpen, 0u, __ATOMIC_RELEASE);
+        SpinGuard guard(&writeLock);
+        if (writer.file != FILE_NONE) finishFile();
+    }
+}
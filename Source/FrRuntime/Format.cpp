@@ -0,0 +1,524 @@
+#include <stdarg.h>
+
+#include <FrogEngine/Runtime.h>
+#include <FrogEngine/Utility.h>
+
+namespace FrogEngine {
+    struct FormatOutput {
+        char* buffer;
+        usize size;
+        usize length;
+    };
+
+    struct FormatSpec {
+        bool left {};
+        bool zero {};
+        bool alternate {};
+        char sign {}; ///< '+', ' ' or 0
+        i32  width {};
+        i32  precision { -1 };
+    };
+
+    // Room left before the terminator, which `length` may already be past.
+    static usize getRoom(const FormatOutput* out) {
+        return out->length + 1 < out->size ? out->size - 1 - out->length : 0;
+    }
+    static void putChar(FormatOutput* out, char c) {
+        if (out->length + 1 < out->size) out->buffer[out->length] = c;
+        out->length++;
+    }
+    static void putRepeated(FormatOutput* out, char c, i32 count) {
+        if (count <= 0) return;
+        const usize room = getRoom(out);
+        __builtin_memset(out->buffer + out->length, c, (usize)count < room ? count : room);
+        out->length += count;
+    }
+    static void putText(FormatOutput* out, const char* text, usize length) {
+        const usize room = getRoom(out);
+        __builtin_memcpy(out->buffer + out->length, text, length < room ? length : room);
+        out->length += length;
+    }
+
+    // Lays out [padding][prefix][zeros][digits][padding] for one conversion.
+    static void putField(
+        FormatOutput*     out,
+        const FormatSpec &spec,
+        const char*       prefix,
+        usize             prefix_length,
+        const char*       digits,
+        usize             digit_length,
+        i32               zeros) {
+        i32 padding = spec.width - (i32)(prefix_length + digit_length) - zeros;
+        if (padding < 0) padding = 0;
+
+        if (!spec.left && !spec.zero) putRepeated(out, ' ', padding);
+        putText(out, prefix, prefix_length);
+        if (!spec.left && spec.zero) putRepeated(out, '0', padding);
+        putRepeated(out, '0', zeros);
+        putText(out, digits, digit_length);
+        if (spec.left) putRepeated(out, ' ', padding);
+    }
+
+    // "00" to "99", so decimals take one division per two digits.
+    static constexpr char DIGIT_PAIRS[] {
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899"
+    };
+
+    // Writes `value` backwards into the end of `digits` and returns where it starts. Hex and
+    // octal digits are shifted out instead of divided.
+    static char* writeDigits(char* end, u64 value, u32 base, bool upper) {
+        char* cursor = end;
+        if (base == 10) {
+            while (value >= 100) {
+                const u64 pair  = value % 100 * 2;
+                value          /= 100;
+                *--cursor       = DIGIT_PAIRS[pair + 1];
+                *--cursor       = DIGIT_PAIRS[pair];
+            }
+            if (value >= 10) {
+                *--cursor = DIGIT_PAIRS[value * 2 + 1];
+                *--cursor = DIGIT_PAIRS[value * 2];
+            } else {
+                *--cursor = (char)('0' + value);
+            }
+            return cursor;
+        }
+
+        const char* symbols = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+        const u32   shift   = base == 16 ? 4 : 3;
+        do {
+            *--cursor   = symbols[value & (base - 1)];
+            value     >>= shift;
+        } while (value);
+        return cursor;
+    }
+
+    static void putInteger(
+        FormatOutput* out, FormatSpec spec, u64 value, bool negative, u32 base, bool upper) {
+        char prefix[2];
+        u32  prefix_length = 0;
+        if (negative) prefix[prefix_length++] = '-';
+        else if (spec.sign) prefix[prefix_length++] = spec.sign;
+        if (spec.alternate && base == 16 && value) {
+            prefix[prefix_length++] = '0';
+            prefix[prefix_length++] = upper ? 'X' : 'x';
+        }
+
+        char  digits[24];
+        char* end   = digits + sizeof(digits);
+        char* start = writeDigits(end, value, base, upper);
+        if (spec.alternate && base == 8 && *start != '0') *--start = '0';
+        // An explicit precision of 0 prints nothing for 0.
+        if (!spec.precision && !value) start = end;
+
+        i32 zeros = 0;
+        if (spec.precision >= 0) {
+            zeros     = spec.precision - (i32)(end - start);
+            spec.zero = false;
+        }
+        putField(out, spec, prefix, prefix_length, start, end - start, zeros < 0 ? 0 : zeros);
+    }
+
+    static void putFloat(FormatOutput* out, FormatSpec spec, f64 value) {
+        // Sign, infinity and NaN come from the bits, since -ffast-math folds away comparisons
+        // that only hold for them.
+        constexpr u64 EXPONENT_MASK { 0x7FF0'0000'0000'0000 };
+        const u64     bits = __builtin_bit_cast(u64, value);
+
+        char prefix[1];
+        u32  prefix_length = 0;
+        if (bits >> 63) {
+            prefix[prefix_length++] = '-';
+            value                   = -value;
+        } else if (spec.sign) {
+            prefix[prefix_length++] = spec.sign;
+        }
+
+        if ((bits & EXPONENT_MASK) == EXPONENT_MASK) {
+            const bool nan = bits & ~(EXPONENT_MASK | 1ull << 63);
+            spec.zero      = false;
+            putField(out, spec, prefix, prefix_length, nan ? "nan" : "inf", 3, 0);
+            return;
+        }
+
+        // Fractions are scaled into a u64, which keeps 15 digits exact in a double. Further
+        // digits are padded with zeros.
+        constexpr u32 EXACT_DIGITS { 15 };
+        const i32     precision = spec.precision < 0 ? 6 : spec.precision;
+        const i32     exact     = precision < (i32)EXACT_DIGITS ? precision : (i32)EXACT_DIGITS;
+        u64           scale     = 1;
+        for (i32 i = 0; i < exact; i++) scale *= 10;
+
+        // Values past u64 keep their leading digits and pad with zeros.
+        u32 exponent = 0;
+        while (value >= 1e19) {
+            value /= 10;
+            exponent++;
+        }
+
+        // Round half to even like the C library does for exact ties.
+        u64       whole    = (u64)value;
+        const f64 scaled   = (value - (f64)whole) * (f64)scale;
+        u64       fraction = (u64)scaled;
+        const f64 rest     = scaled - (f64)fraction;
+        if (rest > 0.5 || (rest == 0.5 && (exact ? fraction : whole) & 1)) fraction++;
+        if (fraction >= scale) {
+            fraction -= scale;
+            whole++;
+        }
+
+        char  digits[64];
+        char* end    = digits + sizeof(digits);
+        char* cursor = end;
+        if (exact) {
+            // The fraction keeps its leading zeros.
+            char* const start = end - exact;
+            cursor            = writeDigits(end, fraction, 10, false);
+            while (cursor > start) *--cursor = '0';
+        }
+        if (precision || spec.alternate) *--cursor = '.';
+        cursor = writeDigits(cursor, whole, 10, false);
+
+        // Trailing zeros go after the digits, so lay the field out by hand.
+        const i32 trailing = (i32)exponent + (precision - exact);
+        i32       padding  = spec.width - (i32)(prefix_length + (end - cursor)) - trailing;
+        if (padding < 0) padding = 0;
+        if (!spec.left && !spec.zero) putRepeated(out, ' ', padding);
+        putText(out, prefix, prefix_length);
+        if (!spec.left && spec.zero) putRepeated(out, '0', padding);
+        if (exponent) {
+            // Zeros of the exponent belong before the decimal point.
+            char* point = cursor;
+            while (point < end && *point != '.') point++;
+            putText(out, cursor, point - cursor);
+            putRepeated(out, '0', (i32)exponent);
+            putText(out, point, end - point);
+        } else {
+            putText(out, cursor, end - cursor);
+        }
+        putRepeated(out, '0', precision - exact);
+        if (spec.left) putRepeated(out, ' ', padding);
+    }
+
+    enum FormatLength : u8 { LENGTH_INT, LENGTH_CHAR, LENGTH_SHORT, LENGTH_LONG, LENGTH_LONG_LONG };
+
+    // Whether the argument is 64 bits. A long is only 32 on Windows.
+    static bool isWide(FormatLength length) {
+        return length == LENGTH_LONG_LONG || (length == LENGTH_LONG && sizeof(long) == sizeof(i64));
+    }
+
+    // Argument sources for the formatter. `wide` reads a 64 bit value instead of an int.
+    struct VaArguments {
+        va_list list;
+
+        i64         readInt(bool wide) { return wide ? va_arg(list, i64) : va_arg(list, int); }
+        u64         readUnsigned(bool wide) { return wide ? va_arg(list, u64) : va_arg(list, u32); }
+        f64         readFloat() { return va_arg(list, f64); }
+        uptr        readPointer() { return (uptr)va_arg(list, void*); }
+        const char* readText() { return va_arg(list, const char*); }
+    };
+
+    // Arguments laid out by captureFormat(): one 8 byte slot per value, and text as its length
+    // followed by the characters and a terminator, padded to 8 bytes.
+    struct CapturedArguments {
+        const u8* cursor;
+
+        u64 readSlot() {
+            u64 value;
+            __builtin_memcpy(&value, cursor, sizeof(value));
+            cursor += sizeof(value);
+            return value;
+        }
+        i64         readInt(bool wide) { return wide ? (i64)readSlot() : (i32)readSlot(); }
+        u64         readUnsigned(bool wide) { return wide ? readSlot() : (u32)readSlot(); }
+        f64         readFloat() { return __builtin_bit_cast(f64, readSlot()); }
+        uptr        readPointer() { return (uptr)readSlot(); }
+        const char* readText() {
+            const u64 length = readSlot();
+            if (length == CAPTURE_NULL_TEXT) return nullptr;
+            const char* text = (const char*)cursor;
+            cursor          += (length + 8) & ~7ull;
+            return text;
+        }
+    };
+
+    // Reads from a va_list like VaArguments and records every value for CapturedArguments.
+    // Text is cut short to fit; `overflow` is set when a slot does not.
+    struct CaptureArguments {
+        va_list list;
+        u8*     cursor;
+        u8*     end;
+        bool    overflow {};
+
+        u64 writeSlot(u64 value) {
+            if ((usize)(end - cursor) < sizeof(value)) {
+                overflow = true;
+                return value;
+            }
+            __builtin_memcpy(cursor, &value, sizeof(value));
+            cursor += sizeof(value);
+            return value;
+        }
+        i64 readInt(bool wide) {
+            return (i64)writeSlot((u64)(wide ? va_arg(list, i64) : va_arg(list, int)));
+        }
+        u64 readUnsigned(bool wide) {
+            return writeSlot(wide ? va_arg(list, u64) : va_arg(list, u32));
+        }
+        f64 readFloat() {
+            return __builtin_bit_cast(f64, writeSlot(__builtin_bit_cast(u64, va_arg(list, f64))));
+        }
+        uptr        readPointer() { return (uptr)writeSlot((uptr)va_arg(list, void*)); }
+        const char* readText() {
+            const char* text = va_arg(list, const char*);
+            if (!text) {
+                writeSlot(CAPTURE_NULL_TEXT);
+                return text;
+            }
+            // The length slot and at least the terminator have to fit.
+            const usize room = (usize)(end - cursor);
+            if (room < sizeof(u64) + 8) {
+                overflow = true;
+                return text;
+            }
+            const usize limit  = room - sizeof(u64) - 1;
+            usize       length = 0;
+            while (text[length] && length < limit) length++;
+            writeSlot(length);
+            __builtin_memcpy(cursor, text, length);
+            cursor[length]     = '\0';
+            const usize padded = (length + 8) & ~7ull;
+            cursor            += padded < (usize)(end - cursor) ? padded : (usize)(end - cursor);
+            return text;
+        }
+    };
+
+    // Parses the flags, width, precision and length of the conversion after a '%', reading
+    // '*' values from `args`. Returns the conversion character, or 0 at the end of the string.
+    template <typename Arguments>
+    static char parseConversion(
+        const char** cursor, FormatSpec* spec, FormatLength* length, Arguments* args) {
+        const char* format = *cursor;
+        for (;; format++) {
+            if (*format == '-') spec->left = true;
+            else if (*format == '0') spec->zero = true;
+            else if (*format == '#') spec->alternate = true;
+            else if (*format == '+') spec->sign = '+';
+            else if (*format == ' ' && spec->sign != '+') spec->sign = ' ';
+            else break;
+        }
+
+        if (*format == '*') {
+            spec->width = (i32)args->readInt(false);
+            if (spec->width < 0) spec->left = true, spec->width = -spec->width;
+            format++;
+        } else {
+            while (*format >= '0' && *format <= '9')
+                spec->width = spec->width * 10 + *format++ - '0';
+        }
+        if (*format == '.') {
+            format++;
+            spec->precision = 0;
+            if (*format == '*') {
+                spec->precision = (i32)args->readInt(false);
+                format++;
+            } else {
+                while (*format >= '0' && *format <= '9')
+                    spec->precision = spec->precision * 10 + *format++ - '0';
+            }
+        }
+
+        *length = LENGTH_INT;
+        switch (*format) {
+            case 'h':
+                *length  = format[1] == 'h' ? LENGTH_CHAR : LENGTH_SHORT;
+                format  += *length == LENGTH_CHAR ? 2 : 1;
+                break;
+            case 'l':
+                *length  = format[1] == 'l' ? LENGTH_LONG_LONG : LENGTH_LONG;
+                format  += *length == LENGTH_LONG_LONG ? 2 : 1;
+                break;
+            case 'z':
+            case 'j':
+            case 't':
+                *length = LENGTH_LONG_LONG;
+                format++;
+                break;
+            case 'L': format++; break;
+        }
+
+        const char type = *format;
+        if (type) format++;
+        *cursor = format;
+        return type;
+    }
+
+    template <typename Arguments>
+    static i32 formatWith(char* buffer, usize _size, const char* format, Arguments* args) {
+        FormatOutput out { buffer, _size, 0 };
+
+        while (*format) {
+            if (*format != '%') {
+                // Copy the whole run of plain text up to the next conversion at once.
+                const char* text = format;
+                while (*format && *format != '%') format++;
+                putText(&out, text, format - text);
+                continue;
+            }
+            const char* conversion = format++;
+
+            FormatSpec   spec {};
+            FormatLength length;
+            const char   type = parseConversion(&format, &spec, &length, args);
+            switch (type) {
+                case 'd':
+                case 'i': {
+                    i64 value = args->readInt(isWide(length));
+                    if (length == LENGTH_CHAR) value = (i8)value;
+                    if (length == LENGTH_SHORT) value = (i16)value;
+                    const u64 magnitude = value < 0 ? 0 - (u64)value : (u64)value;
+                    putInteger(&out, spec, magnitude, value < 0, 10, false);
+                    break;
+                }
+                case 'u':
+                case 'x':
+                case 'X':
+                case 'o': {
+                    u64 value = args->readUnsigned(isWide(length));
+                    if (length == LENGTH_CHAR) value = (u8)value;
+                    if (length == LENGTH_SHORT) value = (u16)value;
+                    spec.sign = 0;
+                    putInteger(
+                        &out,
+                        spec,
+                        value,
+                        false,
+                        type == 'u' ? 10 : type == 'o' ? 8 : 16,
+                        type == 'X');
+                    break;
+                }
+                case 'p': {
+                    spec.alternate = true;
+                    spec.sign      = 0;
+                    putInteger(&out, spec, args->readPointer(), false, 16, false);
+                    break;
+                }
+                case 'f':
+                case 'F': putFloat(&out, spec, args->readFloat()); break;
+                case 's': {
+                    const char* text = args->readText();
+                    if (!text) text = "(null)";
+                    usize text_length = 0;
+                    while (text[text_length]
+                           && (spec.precision < 0 || text_length < (usize)spec.precision))
+                        text_length++;
+                    spec.zero = false;
+                    putField(&out, spec, "", 0, text, text_length, 0);
+                    break;
+                }
+                case 'c': {
+                    const char c = (char)args->readInt(false);
+                    spec.zero    = false;
+                    putField(&out, spec, "", 0, &c, 1, 0);
+                    break;
+                }
+                case '%': putChar(&out, '%'); break;
+                // Anything else is copied as is, so mistakes show up in the output.
+                default: putText(&out, conversion, format - conversion); break;
+            }
+        }
+
+        if (_size) buffer[out.length < _size ? out.length : _size - 1] = '\0';
+        return (i32)out.length;
+    }
+
+    i32 formatString(char* buffer, usize _size, const char* format, va_list args) {
+        VaArguments arguments;
+        va_copy(arguments.list, args);
+        const i32 length = formatWith(buffer, _size, format, &arguments);
+        va_end(arguments.list);
+        return length;
+    }
+
+    // Reads every argument `format` consumes from `args`, without formatting anything.
+    template <typename Arguments>
+    static void readArguments(const char* format, Arguments* args) {
+        while (*format) {
+            if (*format++ != '%') continue;
+
+            FormatSpec   spec {};
+            FormatLength length;
+            switch (parseConversion(&format, &spec, &length, args)) {
+                case 'd':
+                case 'i': args->readInt(isWide(length)); break;
+                case 'c': args->readInt(false); break;
+                case 'u':
+                case 'x':
+                case 'X':
+                case 'o': args->readUnsigned(isWide(length)); break;
+                case 'p': args->readPointer(); break;
+                case 'f':
+                case 'F': args->readFloat(); break;
+                case 's': args->readText(); break;
+            }
+        }
+    }
+
+    // Records the kind of every argument instead of reading one.
+    struct ArgumentKinds {
+        FormatArgument* kinds;
+        u32             max;
+        u32             count {};
+
+        void push(FormatArgument kind) {
+            if (count < max) kinds[count] = kind;
+            count++;
+        }
+        i64 readInt(bool) {
+            push(ARGUMENT_INT);
+            return 0;
+        }
+        u64 readUnsigned(bool) {
+            push(ARGUMENT_UNSIGNED);
+            return 0;
+        }
+        f64 readFloat() {
+            push(ARGUMENT_FLOAT);
+            return 0;
+        }
+        uptr readPointer() {
+            push(ARGUMENT_POINTER);
+            return 0;
+        }
+        const char* readText() {
+            push(ARGUMENT_TEXT);
+            return "";
+        }
+    };
+
+    i64 captureFormat(u8* buffer, usize _size, const char* format, va_list args) {
+        CaptureArguments arguments { .cursor = buffer, .end = buffer + _size };
+        va_copy(arguments.list, args);
+        readArguments(format, &arguments);
+        va_end(arguments.list);
+        return arguments.overflow ? -1 : arguments.cursor - buffer;
+    }
+    u32 getFormatArguments(const char* format, FormatArgument* kinds, u32 max) {
+        ArgumentKinds arguments { kinds, max };
+        readArguments(format, &arguments);
+        return arguments.count;
+    }
+    i32 formatCaptured(char* buffer, usize _size, const char* format, const u8* arguments) {
+        CapturedArguments captured { arguments };
+        return formatWith(buffer, _size, format, &captured);
+    }
+    i32 formatArguments(char* buffer, usize _size, const char* format, ...) {
+        va_list args;
+        va_start(args, format);
+        const i32 length = formatString(buffer, _size, format, args);
+        va_end(args);
+        return length;
+    }
+}
@@ -0,0 +1,274 @@
+#include <FrogEngine/Runtime.h>
+#include <FrogEngine/Syscall.h>
+#include <FrogEngine/Utility.h>
+
+#ifdef FR_OS_WINDOWS
+#    include <direct.h>
+#    include <errno.h>
+#    include <fcntl.h>
+#    include <io.h>
+#    include <stdlib.h>
+#    include <sys/stat.h>
+#    include <windows.h>
+#elif defined(FR_OS_LINUX)
+#    include <elf.h>
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <time.h>
+#else
+#    include <errno.h>
+#    include <fcntl.h>
+#    include <stdlib.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <time.h>
+#    include <unistd.h>
+#endif
+
+namespace FrogEngine {
+#ifdef FR_OS_WINDOWS
+    FileHandle openFile(const char* path, FileMode mode) {
+        if (mode == FILE_READ) return _open(path, _O_RDONLY | _O_BINARY);
+        return _open(path, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+    }
+    i64 readFile(FileHandle file, ptr buffer, usize _size) {
+        return _read(file, buffer, (unsigned)_size);
+    }
+    i64 writeFile(FileHandle file, const void* buffer, usize _size) {
+        return _write(file, buffer, (unsigned)_size);
+    }
+    bool seekFile(FileHandle file, usize offset) {
+        return _lseeki64(file, (i64)offset, SEEK_SET) == (i64)offset;
+    }
+    bool closeFile(FileHandle file) { return _close(file) == 0; }
+    i32  makeDirectory(const char* path) { return _mkdir(path) == 0 ? 0 : errno; }
+    i32  getLastError() { return errno; }
+
+    u64 getTime() {
+        static LARGE_INTEGER frequency {};
+        if (!frequency.QuadPart) QueryPerformanceFrequency(&frequency);
+        LARGE_INTEGER counter;
+        QueryPerformanceCounter(&counter);
+        const u64 ticks = (u64)counter.QuadPart, rate = (u64)frequency.QuadPart;
+        return ticks / rate * 1'000'000'000 + ticks % rate * 1'000'000'000 / rate;
+    }
+
+    ptr mapFile(const char* path, usize _size) {
+        const HANDLE file = CreateFileA(
+            path,
+            GENERIC_READ | GENERIC_WRITE,
+            FILE_SHARE_READ,
+            nullptr,
+            CREATE_ALWAYS,
+            FILE_ATTRIBUTE_NORMAL,
+            nullptr);
+        if (file == INVALID_HANDLE_VALUE) return nullptr;
+        // The mapping grows the file to its size, and the view keeps both alive once closed.
+        const HANDLE mapping = CreateFileMappingA(
+            file, nullptr, PAGE_READWRITE, (DWORD)((u64)_size >> 32), (DWORD)_size, nullptr);
+        const ptr view =
+            mapping ? MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, _size) : nullptr;
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return view;
+    }
+    bool unmapFile(ptr address, usize) { return UnmapViewOfFile(address) != 0; }
+
+    const char* getEnvironment(const char* name) { return getenv(name); }
+#elif defined(FR_OS_LINUX)
+    static thread_local i32 lastError {};
+
+    // System calls return -errno, which is kept for getLastError().
+    static i64 checkError(i64 result) {
+        if (result < 0) lastError = (i32)-result;
+        return result;
+    }
+
+    FileHandle openFile(const char* path, FileMode mode) {
+        const i32 flags = mode == FILE_READ ? O_RDONLY : O_WRONLY | O_CREAT | O_TRUNC;
+        const i64 file =
+            checkError(systemCall(SYSCALL_OPENAT, AT_FDCWD, (i64)path, flags | O_CLOEXEC, 0644));
+        return file < 0 ? FILE_NONE : (FileHandle)file;
+    }
+    i64 readFile(FileHandle file, ptr buffer, usize _size) {
+        return checkError(systemCall(SYSCALL_READ, file, (i64)buffer, (i64)_size));
+    }
+    i64 writeFile(FileHandle file, const void* buffer, usize _size) {
+        return checkError(systemCall(SYSCALL_WRITE, file, (i64)buffer, (i64)_size));
+    }
+    bool seekFile(FileHandle file, usize offset) {
+        return checkError(systemCall(SYSCALL_LSEEK, file, (i64)offset, SEEK_SET)) == (i64)offset;
+    }
+    bool closeFile(FileHandle file) { return checkError(systemCall(SYSCALL_CLOSE, file)) == 0; }
+    i32  makeDirectory(const char* path) {
+        return (i32)-checkError(systemCall(SYSCALL_MKDIRAT, AT_FDCWD, (i64)path, 0755));
+    }
+    i32 getLastError() { return lastError; }
+
+    ptr mapMemory(ptr address, usize _size, i32 protection, i32 flags) {
+        const i64 result =
+            systemCall(SYSCALL_MMAP, (i64)address, (i64)_size, protection, flags, -1, 0);
+        // Errors come back as the last page of the address space.
+        return (u64)result > (u64)-4'096 ? nullptr : (ptr)result;
+    }
+    bool unmapMemory(ptr address, usize _size) {
+        return systemCall(SYSCALL_MUNMAP, (i64)address, (i64)_size) == 0;
+    }
+    bool protectMemory(ptr address, usize _size, i32 protection) {
+        return systemCall(SYSCALL_MPROTECT, (i64)address, (i64)_size, protection) == 0;
+    }
+    bool adviseMemory(ptr address, usize _size, i32 advice) {
+        return systemCall(SYSCALL_MADVISE, (i64)address, (i64)_size, advice) == 0;
+    }
+
+    ptr mapFile(const char* path, usize _size) {
+        const i64 file = checkError(systemCall(
+            SYSCALL_OPENAT, AT_FDCWD, (i64)path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644));
+        if (file < 0) return nullptr;
+        ptr result = nullptr;
+        if (checkError(systemCall(SYSCALL_FTRUNCATE, file, (i64)_size)) == 0) {
+            const i64 address = systemCall(
+                SYSCALL_MMAP, 0, (i64)_size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+            if ((u64)address <= (u64)-4'096) result = (ptr)address;
+        }
+        // The mapping keeps the file open.
+        systemCall(SYSCALL_CLOSE, file);
+        return result;
+    }
+    bool unmapFile(ptr address, usize _size) { return unmapMemory(address, _size); }
+
+    typedef int (*ClockFunction)(clockid_t clock, struct timespec* time);
+
+    static char**        environment { nullptr };
+    static usize*        auxiliary { nullptr };
+    static ClockFunction vdsoClock { nullptr };
+
+    // Looks up clock_gettime() in the vDSO the kernel maps into every process, which reads the
+    // clock without entering the kernel. Returns nullptr when the vDSO has no symbol hash table.
+    static ClockFunction findVdsoClock(uptr base) {
+#    if defined(__x86_64__)
+        const char* const name = "__vdso_clock_gettime";
+#    elif defined(__aarch64__)
+        const char* const name = "__kernel_clock_gettime";
+#    endif
+        if (!base) return nullptr;
+        const Elf64_Ehdr* header   = (const Elf64_Ehdr*)base;
+        const Elf64_Phdr* segments = (const Elf64_Phdr*)(base + header->e_phoff);
+        const Elf64_Dyn*  dynamic  = nullptr;
+        uptr              bias     = 0;
+        for (u32 i = 0; i < header->e_phnum; i++) {
+            if (segments[i].p_type == PT_LOAD && !bias)
+                bias = base + segments[i].p_offset - segments[i].p_vaddr;
+            if (segments[i].p_type == PT_DYNAMIC)
+                dynamic = (const Elf64_Dyn*)(base + segments[i].p_offset);
+        }
+        if (!dynamic) return nullptr;
+
+        const Elf64_Sym* symbols = nullptr;
+        const char*      strings = nullptr;
+        const u32*       hash    = nullptr;
+        for (; dynamic->d_tag != DT_NULL; dynamic++) {
+            const uptr address = bias + dynamic->d_un.d_ptr;
+            if (dynamic->d_tag == DT_SYMTAB) symbols = (const Elf64_Sym*)address;
+            if (dynamic->d_tag == DT_STRTAB) strings = (const char*)address;
+            if (dynamic->d_tag == DT_HASH) hash = (const u32*)address;
+        }
+        if (!symbols || !strings || !hash) return nullptr;
+
+        // The second word of the SysV hash table is the number of symbols.
+        for (u32 i = 0; i < hash[1]; i++) {
+            if (!symbols[i].st_value || ELF64_ST_TYPE(symbols[i].st_info) != STT_FUNC) continue;
+            const char* symbol = strings + symbols[i].st_name;
+            const char* key    = name;
+            while (*key && *key == *symbol) key++, symbol++;
+            if (!*key && !*symbol) return (ClockFunction)(bias + symbols[i].st_value);
+        }
+        return nullptr;
+    }
+
+    // Both FrogStart and the C library pass the arguments and environment to constructors. The
+    // auxiliary vector follows the environment on the initial stack.
+    __attribute__((constructor(101))) static void captureEnvironment(
+        int argc, char** argv, char** envp) {
+        (void)argc, (void)argv;
+        environment = envp;
+
+        char** entry = envp;
+        while (*entry) entry++;
+        auxiliary = (usize*)(entry + 1);
+        vdsoClock = findVdsoClock(getAuxiliary(AT_SYSINFO_EHDR));
+    }
+
+    u64 getTime() {
+        struct timespec time {};
+        if (!vdsoClock || vdsoClock(CLOCK_MONOTONIC, &time))
+            systemCall(SYSCALL_CLOCK_GETTIME, CLOCK_MONOTONIC, (i64)&time);
+        return (u64)time.tv_sec * 1'000'000'000 + (u64)time.tv_nsec;
+    }
+
+    const char* getEnvironment(const char* name) {
+        if (!environment) return nullptr;
+        for (char** entry = environment; *entry; entry++) {
+            const char* variable = *entry;
+            const char* key      = name;
+            while (*key && *key == *variable) key++, variable++;
+            if (!*key && *variable == '=') return variable + 1;
+        }
+        return nullptr;
+    }
+    usize getAuxiliary(usize type) {
+        if (!auxiliary) return 0;
+        for (usize* entry = auxiliary; entry[0] != AT_NULL; entry += 2)
+            if (entry[0] == type) return entry[1];
+        return 0;
+    }
+#else
+    FileHandle openFile(const char* path, FileMode mode) {
+        if (mode == FILE_READ) return open(path, O_RDONLY | O_CLOEXEC);
+        return open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    }
+    i64  readFile(FileHandle file, ptr buffer, usize _size) { return read(file, buffer, _size); }
+    i64  writeFile(FileHandle file, const void* buffer, usize _size) {
+        return write(file, buffer, _size);
+    }
+    bool seekFile(FileHandle file, usize offset) {
+        return lseek(file, (off_t)offset, SEEK_SET) == (off_t)offset;
+    }
+    bool closeFile(FileHandle file) { return close(file) == 0; }
+    i32  makeDirectory(const char* path) { return mkdir(path, 0755) == 0 ? 0 : errno; }
+    i32  getLastError() { return errno; }
+
+    u64 getTime() {
+        struct timespec time {};
+        clock_gettime(CLOCK_MONOTONIC, &time);
+        return (u64)time.tv_sec * 1'000'000'000 + (u64)time.tv_nsec;
+    }
+
+    ptr mapMemory(ptr address, usize _size, i32 protection, i32 flags) {
+        const ptr result = mmap(address, _size, protection, flags, -1, 0);
+        return result == MAP_FAILED ? nullptr : result;
+    }
+    bool unmapMemory(ptr address, usize _size) { return munmap(address, _size) == 0; }
+    bool protectMemory(ptr address, usize _size, i32 protection) {
+        return mprotect(address, _size, protection) == 0;
+    }
+    bool adviseMemory(ptr address, usize _size, i32 advice) {
+        return madvise(address, _size, advice) == 0;
+    }
+
+    ptr mapFile(const char* path, usize _size) {
+        const int file = open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (file < 0) return nullptr;
+        ptr result = nullptr;
+        if (ftruncate(file, (off_t)_size) == 0) {
+            result = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+            if (result == MAP_FAILED) result = nullptr;
+        }
+        close(file);
+        return result;
+    }
+    bool unmapFile(ptr address, usize _size) { return unmapMemory(address, _size); }
+
+    const char* getEnvironment(const char* name) { return getenv(name); }
+#endif
+}
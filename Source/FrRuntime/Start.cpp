@@ -0,0 +1,213 @@
+#include <elf.h>
+#include <sys/mman.h>
+
+#include <FrogEngine/Syscall.h>
+#include <FrogEngine/Utility.h>
+
+// Program entry and the C library symbols compilers emit calls to, for executables linked with
+// -nostdlib. Built as its own library: executables that link libc must not link it.
+//
+// Static executables get their thread pointer set up here from PT_TLS. Dynamic ones already had
+// it set up by the dynamic linker. Static PIE executables are not relocated, so static builds
+// have to link with -no-pie.
+
+#ifdef FR_OS_LINUX
+using namespace FrogEngine;
+
+extern "C" {
+typedef void (*InitFunction)(int, char**, char**);
+typedef void (*FiniFunction)();
+
+extern InitFunction __preinit_array_start[] __attribute__((weak, visibility("hidden")));
+extern InitFunction __preinit_array_end[] __attribute__((weak, visibility("hidden")));
+extern InitFunction __init_array_start[] __attribute__((weak, visibility("hidden")));
+extern InitFunction __init_array_end[] __attribute__((weak, visibility("hidden")));
+extern FiniFunction __fini_array_start[] __attribute__((weak, visibility("hidden")));
+extern FiniFunction __fini_array_end[] __attribute__((weak, visibility("hidden")));
+
+int main(int argc, char** argv, char** envp);
+
+__attribute__((visibility("hidden"))) void* __dso_handle = &__dso_handle;
+}
+
+namespace {
+    constexpr u32   EXIT_HANDLER_COUNT { 64 };
+    constexpr usize THREAD_CONTROL_SIZE { 64 };
+    constexpr i64   ARCH_SET_FS { 0x1002 };
+
+    struct ExitHandler {
+        void (*function)(ptr);
+        ptr argument;
+    };
+
+    ExitHandler exitHandlers[EXIT_HANDLER_COUNT];
+    u32         exitHandlerCount {};
+    bool        exiting {};
+
+    void callFunction(ptr function) { ((FiniFunction)function)(); }
+
+    // Copies the TLS image into a block next to the thread control block and points the thread
+    // register at it. x86-64 places TLS below the thread pointer and aarch64 above it.
+    void setupThreadStorage(const Elf64_Phdr* headers, usize count, usize bias) {
+        const Elf64_Phdr* tls = nullptr;
+        for (usize i = 0; i < count; i++)
+            if (headers[i].p_type == PT_TLS) tls = &headers[i];
+
+        // Thread pointer offsets are computed by the linker from the segment's own alignment.
+        const usize align  = tls && tls->p_align > 1 ? tls->p_align : 1;
+        const usize image  = tls ? tls->p_memsz + align - 1 & ~(align - 1) : 0;
+        const usize header = align > 16 ? align : 16;
+        const usize total  = image + THREAD_CONTROL_SIZE + header * 2;
+
+        const i32 protection = PROT_READ | PROT_WRITE;
+        const i64 block =
+            systemCall(SYSCALL_MMAP, 0, (i64)total, protection, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if ((u64)block > (u64)-4'096) systemCall(SYSCALL_EXIT_GROUP, 127);
+
+#    if defined(__x86_64__)
+        const uptr thread  = (uptr)block + image + header - 1 & ~(header - 1);
+        u8*        storage = (u8*)(thread - image);
+        *(uptr*)thread     = thread;
+#    elif defined(__aarch64__)
+        const uptr thread  = (uptr)block + header - 1 & ~(header - 1);
+        u8*        storage = (u8*)(thread + (16 + align - 1 & ~(align - 1)));
+#    endif
+        if (tls) {
+            const u8* source = (const u8*)(tls->p_vaddr + bias);
+            for (usize i = 0; i < tls->p_filesz; i++) storage[i] = source[i];
+        }
+
+#    if defined(__x86_64__)
+        systemCall(SYSCALL_ARCH_PRCTL, ARCH_SET_FS, (i64)thread);
+#    elif defined(__aarch64__)
+        asm volatile("msr tpidr_el0, %0" : : "r"(thread));
+#    endif
+    }
+}
+
+extern "C" {
+int __cxa_atexit(void (*function)(ptr), ptr argument, ptr dso) {
+    (void)dso;
+    if (exitHandlerCount == EXIT_HANDLER_COUNT) return -1;
+    exitHandlers[exitHandlerCount++] = { function, argument };
+    return 0;
+}
+int atexit(void (*function)()) { return __cxa_atexit(callFunction, (ptr)function, nullptr); }
+
+__attribute__((noreturn)) void exit(int code) {
+    if (!exiting) {
+        exiting = true;
+        while (exitHandlerCount) {
+            const ExitHandler &handler = exitHandlers[--exitHandlerCount];
+            handler.function(handler.argument);
+        }
+        for (FiniFunction* fini = __fini_array_end; fini != __fini_array_start;) (*--fini)();
+    }
+    for (;;) systemCall(SYSCALL_EXIT_GROUP, code);
+}
+
+__attribute__((noreturn, used)) void frogStart(usize* stack, FiniFunction dynamic_fini) {
+    const int argc = (int)stack[0];
+    char**    argv = (char**)(stack + 1);
+    char**    envp = argv + argc + 1;
+
+    char** entry = envp;
+    while (*entry) entry++;
+    const usize* auxiliary = (const usize*)(entry + 1);
+
+    const Elf64_Phdr* headers = nullptr;
+    usize             count   = 0;
+    for (const usize* aux = auxiliary; aux[0] != AT_NULL; aux += 2) {
+        if (aux[0] == AT_PHDR) headers = (const Elf64_Phdr*)aux[1];
+        if (aux[0] == AT_PHNUM) count = aux[1];
+    }
+
+    bool  dynamic = false;
+    usize bias    = 0;
+    for (usize i = 0; i < count; i++) {
+        if (headers[i].p_type == PT_INTERP) dynamic = true;
+        if (headers[i].p_type == PT_PHDR) bias = (uptr)headers - headers[i].p_vaddr;
+    }
+    if (!dynamic) setupThreadStorage(headers, count, bias);
+    if (dynamic_fini) atexit(dynamic_fini);
+
+    for (InitFunction* init = __preinit_array_start; init != __preinit_array_end; init++)
+        (*init)(argc, argv, envp);
+    for (InitFunction* init = __init_array_start; init != __init_array_end; init++)
+        (*init)(argc, argv, envp);
+
+    exit(main(argc, argv, envp));
+}
+
+// The kernel starts the process with argc at the stack pointer. The dynamic linker also leaves
+// its finalizer in rdx or x0.
+#    if defined(__x86_64__)
+asm(".text\n"
+    ".global _start\n"
+    ".type _start, @function\n"
+    "_start:\n"
+    "    xor %ebp, %ebp\n"
+    "    mov %rsp, %rdi\n"
+    "    mov %rdx, %rsi\n"
+    "    and $-16, %rsp\n"
+    "    call frogStart\n"
+    "    hlt\n");
+#    elif defined(__aarch64__)
+asm(".text\n"
+    ".global _start\n"
+    ".type _start, %function\n"
+    "_start:\n"
+    "    mov x29, #0\n"
+    "    mov x30, #0\n"
+    "    mov x1, x0\n"
+    "    mov x0, sp\n"
+    "    bl frogStart\n"
+    "    brk #0\n");
+#    endif
+
+// Built with -ffreestanding and without loop idiom recognition, so these loops are not turned
+// back into calls to themselves.
+void* memcpy(void* destination, const void* source, usize _size) {
+#    if defined(__x86_64__)
+    void* result = destination;
+    asm volatile("rep movsb" : "+D"(destination), "+S"(source), "+c"(_size) : : "memory");
+    return result;
+#    else
+    u8*       to   = (u8*)destination;
+    const u8* from = (const u8*)source;
+    for (usize i = 0; i < _size; i++) to[i] = from[i];
+    return destination;
+#    endif
+}
+void* memmove(void* destination, const void* source, usize _size) {
+    u8*       to   = (u8*)destination;
+    const u8* from = (const u8*)source;
+    if (to <= from || to >= from + _size) return memcpy(destination, source, _size);
+    while (_size--) to[_size] = from[_size];
+    return destination;
+}
+void* memset(void* destination, int value, usize _size) {
+#    if defined(__x86_64__)
+    void* result = destination;
+    asm volatile("rep stosb" : "+D"(destination), "+c"(_size) : "a"(value) : "memory");
+    return result;
+#    else
+    u8* to = (u8*)destination;
+    for (usize i = 0; i < _size; i++) to[i] = (u8)value;
+    return destination;
+#    endif
+}
+int memcmp(const void* left, const void* right, usize _size) {
+    const u8* a = (const u8*)left;
+    const u8* b = (const u8*)right;
+    for (usize i = 0; i < _size; i++)
+        if (a[i] != b[i]) return a[i] - b[i];
+    return 0;
+}
+usize strlen(const char* text) {
+    usize length = 0;
+    while (text[length]) length++;
+    return length;
+}
+}
+#endif
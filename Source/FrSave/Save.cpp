@@ -1,178 +1,149 @@
 #include <errno.h>
-#include <stdio.h>
-#include <stdlib.h>
 
 #include <FrogEngine/Allocator.h>
+#include <FrogEngine/Format.h>
 #include <FrogEngine/Log.h>
+#include <FrogEngine/Profile.h>
+#include <FrogEngine/Runtime.h>
 #include <FrogEngine/Save.h>
 #include <FrogEngine/Utility.h>
 
-#ifdef FR_OS_WINDOWS
-#    include <direct.h>
-#    define mkdir(path, mode) _mkdir(path)
-#else
-#    include <sys/stat.h>
-#    define mkdir(path, mode) mkdir(path, mode)
-#endif
-
 namespace FrogEngine {
+    // Layout written by engines before the static and frame sizes were learned.
+    struct EngineCacheV1 {
+        u32   version;
+        usize allocatorCache;
+    };
+
+    // Keeps a quarter of headroom over the measured peak, rounded up to whole kilobytes.
+    static usize learnSize(usize previous, usize peak) {
+        const usize learned = peak + peak / 4 + 1'023 & ~(usize)1'023;
+        return learned > previous ? learned : previous;
+    }
+
+    u32 readEngineCache(const char* path, EngineCache* cache) {
+        const FileHandle file = openFile(path, FILE_READ);
+        if (file == FILE_NONE) return 0;
+
+        u32 version {};
+        if (readFile(file, &version, sizeof(u32)) != sizeof(u32) || !seekFile(file, 0)) {
+            closeFile(file);
+            return 0;
+        }
+
+        EngineCache current {};
+        bool        read { false };
+        if (version == current.version) {
+            read = readFile(file, &current, sizeof(EngineCache)) == sizeof(EngineCache);
+        } else if (version == 1) {
+            EngineCacheV1 old {};
+            read                   = readFile(file, &old, sizeof(old)) == sizeof(old);
+            current.allocatorCache = old.allocatorCache;
+        }
+        closeFile(file);
+
+        if (!read) return 0;
+        *cache = current;
+        return version;
+    }
+    bool writeEngineCache(const char* path, const EngineCache* cache) {
+        const FileHandle file = openFile(path, FILE_WRITE);
+        if (file == FILE_NONE) return false;
+        const bool written = writeFile(file, cache, sizeof(EngineCache)) == sizeof(EngineCache);
+        return closeFile(file) && written;
+    }
+
     Save::Save(Allocator* allocate) {
-        block = allocate->getStaticBlock();
-        id    = allocate->getID();
+        allocator = allocate;
+        block     = allocate->getStaticBlock();
+        id        = allocate->getID();
+
+        configPath = block->alloc(512, TAG_SAVE);
+        filePath   = block->alloc(512, TAG_SAVE);
+    }
+    Save::~Save() {
+        if (filePath[0] == '\0') return;
 
-        configPath = block->alloc(512);
-        filePath   = block->alloc(512);
+        // Sizes only ever grow so a light session does not undo what a heavy one learned.
+        EngineCache learned {};
+        learned.staticCache = learnSize(engineCache.staticCache, block->getPeak());
+        learned.frameCache =
+            learnSize(engineCache.frameCache, allocator->getFrameBlock()->getPeak());
+        learned.allocatorCache =
+            learnSize(engineCache.allocatorCache, allocator->getDynamicBlock()->getPeak());
+
+        if (!writeEngineCache(filePath, &learned)) {
+            FR_LOG_WARNING(SAVE, "Failed to write %s. Code %i", filePath.get(), getLastError());
+            return;
+        }
+        FR_LOG_INFO(SAVE, "Saved engine cache to %s", filePath.get());
+        FR_LOG_INFO(SAVE, "  %zu for static memory", learned.staticCache);
+        FR_LOG_INFO(SAVE, "  %zu for frame memory", learned.frameCache);
+        FR_LOG_INFO(SAVE, "  %zu for dynamic memory", learned.allocatorCache);
     }
-    Save::~Save() {}
 
     void Save::init() {
+        FR_PROFILE_SCOPE("Save::init");
         if (configPath[0] != '\0') {
-            logWarning(
-                "%sSAVE%s: Called init() after initialization",
-                FR_LOG_FORMAT_BRIGHT_GREEN,
-                FR_LOG_FORMAT_RESET);
+            FR_LOG_WARNING(SAVE, "Called init() after initialization");
             return;
         }
 
         const char* base_path { nullptr };
 
 #ifdef FR_OS_WINDOWS
-        base_path = getenv("LOCALAPPDATA");
+        base_path = getEnvironment("LOCALAPPDATA");
         if (!base_path)
-            logError(
-                "%sSAVE%s: LOCALAPPDATA not found",
-                FR_LOG_FORMAT_BRIGHT_GREEN,
-                FR_LOG_FORMAT_RESET);
+            FR_LOG_ERROR(SAVE, "LOCALAPPDATA not found");
 #else
-        base_path = getenv("XDG_CONFIG_HOME");
-        if (!basePath) {
-            base_path = getenv("HOME");
+        base_path = getEnvironment("XDG_CONFIG_HOME");
+        if (!base_path) {
+            base_path = getEnvironment("HOME");
             if (!base_path)
-                logError(
-                    "%sSAVE%s: Neither XDG_CONFIG_HOME nor HOME is set",
-                    FR_LOG_FORMAT_BRIGHT_GREEN,
-                    FR_LOG_FORMAT_RESET);
+                FR_LOG_ERROR(SAVE, "Neither XDG_CONFIG_HOME nor HOME is set");
         }
 #endif
 
-        if (snprintf(configPath, 512, "%s/FrogEngine", base_path) >= 512)
-            logError(
-                "%sSAVE%s: FrogEngine save path too long",
-                FR_LOG_FORMAT_BRIGHT_GREEN,
-                FR_LOG_FORMAT_RESET);
-        if (mkdir(configPath, 0755) != 0 && errno != EEXIST)
-            logError(
-                "%sSAVE%s: Failed to create directory at %s (errno: %d)",
-                FR_LOG_FORMAT_BRIGHT_GREEN,
-                FR_LOG_FORMAT_RESET,
-                configPath.get(),
-                errno);
-
-        if (snprintf(configPath, 512, "%s/FrogEngine/%u", base_path, id) >= 512)
-            logError(
-                "%sSAVE%s: Game save path too long",
-                FR_LOG_FORMAT_BRIGHT_GREEN,
-                FR_LOG_FORMAT_RESET);
-        if (mkdir(configPath, 0755) != 0 && errno != EEXIST)
-            logError(
-                "%sSAVE%s: Failed to create directory at %s (errno: %d)",
-                FR_LOG_FORMAT_BRIGHT_GREEN,
-                FR_LOG_FORMAT_RESET,
-                configPath.get(),
-                errno);
-        if (errno != EEXIST)
-            logInfo(
-                "%sSAVE%s: Created path at %s",
-                FR_LOG_FORMAT_BRIGHT_GREEN,
-                FR_LOG_FORMAT_RESET,
-                configPath.get());
-
-        if (snprintf(filePath, 512, "%s/engine.cache", (char*)configPath.get()) >= 512)
-            logError(
-                "%sSAVE%s: Engine cache save path too long",
-                FR_LOG_FORMAT_BRIGHT_GREEN,
-                FR_LOG_FORMAT_RESET);
-
-        FILE* file = fopen(filePath, "rb");
-        if (!file) {
-            if (errno != ENOENT)
-                logError(
-                    "%sSAVE%s: Failed to read %s. Code %i\n",
-                    FR_LOG_FORMAT_BRIGHT_GREEN,
-                    FR_LOG_FORMAT_RESET,
-                    filePath.get(),
-                    errno);
+        if (formatString(configPath, 512, "%s/FrogEngine", base_path) >= 512)
+            FR_LOG_ERROR(SAVE, "FrogEngine save path too long");
+        i32 error = makeDirectory(configPath);
+        if (error && error != EEXIST)
+            FR_LOG_ERROR(
+                SAVE, "Failed to create directory at %s (errno: %d)", configPath.get(), error);
 
-            engineCache = {};
-            file        = fopen(filePath, "wb");
-            if (!file || fwrite(&engineCache, sizeof(EngineCache), 1, file) != 1)
-                logError(
-                    "%sSAVE%s: Failed to write %s. Code %i",
-                    FR_LOG_FORMAT_BRIGHT_GREEN,
-                    FR_LOG_FORMAT_RESET,
-                    filePath.get(),
-                    errno);
-            fclose(file);
-            logInfo(
-                "%sSAVE%s: Created file %s",
-                FR_LOG_FORMAT_BRIGHT_GREEN,
-                FR_LOG_FORMAT_RESET,
-                filePath.get());
+        if (formatString(configPath, 512, "%s/FrogEngine/%u", base_path, id) >= 512)
+            FR_LOG_ERROR(SAVE, "Game save path too long");
+        error = makeDirectory(configPath);
+        if (error && error != EEXIST)
+            FR_LOG_ERROR(
+                SAVE, "Failed to create directory at %s (errno: %d)", configPath.get(), error);
+        if (!error)
+            FR_LOG_INFO(SAVE, "Created path at %s", configPath.get());
+
+        if (formatString(filePath, 512, "%s/engine.cache", (char*)configPath.get()) >= 512)
+            FR_LOG_ERROR(SAVE, "Engine cache save path too long");
+
+        const u32 version = readEngineCache(filePath, &engineCache);
+        if (version == engineCache.version) {
+            FR_LOG_INFO(SAVE, "Opened file %s", filePath.get());
             return;
         }
 
-        if (fread(&engineCache, sizeof(EngineCache), 1, file) != 1) {
-            fclose(file);
-            logWarning(
-                "%sSAVE%s: Failed to read %s. Code %i",
-                FR_LOG_FORMAT_BRIGHT_GREEN,
-                FR_LOG_FORMAT_RESET,
+        if (version) {
+            FR_LOG_INFO(
+                SAVE,
+                "Migrated %s from version %u to %u",
                 filePath.get(),
-                errno);
-            logWarning("  Rewriting file");
-            remove(filePath);
-            engineCache = {};
-            file        = fopen(filePath, "wb");
-            if (!file || fwrite(&engineCache, sizeof(EngineCache), 1, file) != 1)
-                logError(
-                    "%sSAVE%s: Failed to write %s. Code %i",
-                    FR_LOG_FORMAT_BRIGHT_GREEN,
-                    FR_LOG_FORMAT_RESET,
-                    filePath.get(),
-                    errno);
-            fclose(file);
+                version,
+                engineCache.version);
         } else {
-            fclose(file);
-            logInfo(
-                "%sSAVE%s: Opened file %s",
-                FR_LOG_FORMAT_BRIGHT_GREEN,
-                FR_LOG_FORMAT_RESET,
-                filePath.get());
-            EngineCache current = {};
-            if (engineCache.version != current.version) {
-                logWarning(
-                    "%sSAVE%s: Version mismatch. Found %u, expected %u",
-                    FR_LOG_FORMAT_BRIGHT_GREEN,
-                    FR_LOG_FORMAT_RESET,
-                    engineCache.version,
-                    current.version);
-                logWarning("  Rewriting file");
-                engineCache = {};
-                file        = fopen(filePath, "wb");
-                if (!file || fwrite(&engineCache, sizeof(EngineCache), 1, file) != 1)
-                    logError(
-                        "%sSAVE%s: Failed to write %s. Code %i",
-                        FR_LOG_FORMAT_BRIGHT_GREEN,
-                        FR_LOG_FORMAT_RESET,
-                        filePath.get(),
-                        errno);
-                fclose(file);
-            }
+            if (getLastError() != ENOENT)
+                FR_LOG_WARNING(SAVE, "Failed to read %s. Code %i", filePath.get(), getLastError());
+            engineCache = {};
         }
-        logInfo(
-            "%sSAVE%s: Closed file %s",
-            FR_LOG_FORMAT_BRIGHT_GREEN,
-            FR_LOG_FORMAT_RESET,
-            filePath.get());
+
+        if (!writeEngineCache(filePath, &engineCache))
+            FR_LOG_ERROR(SAVE, "Failed to write %s. Code %i", filePath.get(), getLastError());
+        FR_LOG_INFO(SAVE, "Wrote file %s", filePath.get());
     }
 }
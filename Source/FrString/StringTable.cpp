@@ -0,0 +1,76 @@
+#include <string.h>
+
+#include <FrogEngine/Allocator.h>
+#include <FrogEngine/Log.h>
+#include <FrogEngine/StringId.h>
+#include <FrogEngine/Utility.h>
+
+namespace FrogEngine {
+    StringTable::StringTable(Allocator* _allocator) :
+        block(_allocator->getDynamicBlock()), entries(block, TAG_STRING) {}
+    StringTable::~StringTable() {
+        while (pageSize) {
+            PageHeader header;
+            memcpy(&header, page.get(), sizeof(PageHeader));
+            block->dealloc(page, pageSize);
+            page     = header.previous;
+            pageSize = header.previousSize;
+        }
+    }
+
+    StringId StringTable::intern(const char* text) { return intern(text, strlen(text)); }
+    StringId StringTable::intern(const char* text, usize length) {
+        const StringId id { hashString(text, length) };
+
+        SpinGuard    guard(&lock);
+        const Entry* found = entries.find(id);
+        if (found) {
+#ifdef FR_DEBUG
+            // A warning, since an error would exit with the lock still held. The ID keeps
+            // naming the first string.
+            if (found->length != length || memcmp(found->text.get(), text, length))
+                FR_LOG_WARNING(
+                    STRING,
+                    "\"%.*s\" and \"%s\" have the same ID %llx",
+                    (i32)length,
+                    text,
+                    found->text.get(),
+                    (unsigned long long)id.value);
+#endif
+            return id;
+        }
+
+        entries.insert(id, Entry { store(text, length), length });
+        bytes += length + 1;
+        return id;
+    }
+
+    const char* StringTable::getString(StringId id) {
+        SpinGuard    guard(&lock);
+        const Entry* found = entries.find(id);
+        return found ? found->text.get() : nullptr;
+    }
+
+    usize StringTable::getCount() const { return entries.getCount(); }
+    usize StringTable::getBytes() const { return bytes; }
+
+    // Bumps through the current page and starts a new one when the string does not fit. Strings
+    // longer than a page get a page of their own.
+    Pointer<char> StringTable::store(const char* text, usize length) {
+        if (!pageSize || pageUsed + length + 1 > pageSize) {
+            const PageHeader header { page, pageSize };
+            const usize      needed = sizeof(PageHeader) + length + 1;
+
+            pageSize = needed > STRING_PAGE_SIZE ? needed : STRING_PAGE_SIZE;
+            page     = block->alloc(pageSize, TAG_STRING);
+            pageUsed = sizeof(PageHeader);
+            memcpy(page.get(), &header, sizeof(PageHeader));
+        }
+
+        Pointer<char> result = page + pageUsed;
+        memcpy(result.get(), text, length);
+        result[length]  = '\0';
+        pageUsed       += length + 1;
+        return result;
+    }
+}
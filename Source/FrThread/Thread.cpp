@@ -0,0 +1,294 @@
+#include <FrogEngine/Log.h>
+#include <FrogEngine/Runtime.h>
+#include <FrogEngine/Syscall.h>
+#include <FrogEngine/Thread.h>
+#include <FrogEngine/Utility.h>
+
+#ifdef FR_OS_WINDOWS
+#    include <windows.h>
+#elif defined(FR_OS_LINUX)
+#    include <elf.h>
+#    include <linux/futex.h>
+#    include <linux/sched.h>
+#    include <sys/mman.h>
+#else
+#    include <pthread.h>
+#    include <sched.h>
+#    include <unistd.h>
+#endif
+
+#ifdef FR_OS_LINUX
+// Only resolved when the C library is linked. pthread_t is an unsigned long on Linux.
+extern "C" {
+int pthread_create(u64* thread, const void* attributes, ptr (*function)(ptr), ptr argument)
+    __attribute__((weak));
+int pthread_join(u64 thread, ptr* result) __attribute__((weak));
+
+// Clones a thread that calls function(argument) on `stack` and exits when it returns.
+__attribute__((visibility("hidden"))) i64 frogClone(
+    u64  flags,
+    ptr  stack,
+    u32* parent_id,
+    u32* child_id,
+    ptr  tls,
+    void (*function)(ptr),
+    ptr  argument);
+}
+
+// The child starts on the new stack without a frame to return to, so frogClone() is written
+// in assembly. x86-64 takes clone(flags, stack, parent_id, child_id, tls) as system call 56 and
+// exit as 60.
+#    if defined(__x86_64__)
+asm(".text\n"
+    ".global frogClone\n"
+    ".type frogClone, @function\n"
+    "frogClone:\n"
+    "    mov 8(%rsp), %rax\n"
+    "    and $-16, %rsi\n"
+    "    sub $16, %rsi\n"
+    "    mov %r9, (%rsi)\n"
+    "    mov %rax, 8(%rsi)\n"
+    "    mov %rcx, %r10\n"
+    "    mov $56, %eax\n"
+    "    syscall\n"
+    "    test %rax, %rax\n"
+    "    jnz 1f\n"
+    "    xor %ebp, %ebp\n"
+    "    pop %rax\n"
+    "    pop %rdi\n"
+    "    call *%rax\n"
+    "    mov $60, %eax\n"
+    "    xor %edi, %edi\n"
+    "    syscall\n"
+    "    hlt\n"
+    "1:\n"
+    "    ret\n");
+// aarch64 takes clone(flags, stack, parent_id, tls, child_id) as system call 220 and exit as 93.
+#    elif defined(__aarch64__)
+asm(".text\n"
+    ".global frogClone\n"
+    ".type frogClone, %function\n"
+    "frogClone:\n"
+    "    and x1, x1, #-16\n"
+    "    stp x5, x6, [x1, #-16]!\n"
+    "    mov x9, x3\n"
+    "    mov x3, x4\n"
+    "    mov x4, x9\n"
+    "    mov x8, #220\n"
+    "    svc #0\n"
+    "    cbnz x0, 1f\n"
+    "    mov x29, #0\n"
+    "    ldp x5, x0, [sp], #16\n"
+    "    blr x5\n"
+    "    mov x8, #93\n"
+    "    mov x0, #0\n"
+    "    svc #0\n"
+    "    brk #0\n"
+    "1:\n"
+    "    ret\n");
+#    endif
+#endif
+
+namespace FrogEngine {
+    Thread::Thread() {}
+    Thread::~Thread() {
+        if (running) join();
+    }
+
+    bool Thread::isRunning() const { return running; }
+
+#ifdef FR_OS_WINDOWS
+    bool Thread::start(ThreadFunction _function, ptr _argument, usize stack_size) {
+        if (running) return false;
+        function = _function;
+        argument = _argument;
+
+        handle = CreateThread(
+            nullptr,
+            stack_size,
+            [](LPVOID self) -> DWORD {
+                ((Thread*)self)->function(((Thread*)self)->argument);
+                return 0;
+            },
+            this,
+            0,
+            nullptr);
+        running = handle != nullptr;
+        return running;
+    }
+    void Thread::join() {
+        if (!running) return;
+        running = false;
+        WaitForSingleObject(handle, INFINITE);
+        CloseHandle(handle);
+        handle = nullptr;
+    }
+
+    u32 getCoreCount() { return GetActiveProcessorCount(ALL_PROCESSOR_GROUPS); }
+    void yieldThread() { SwitchToThread(); }
+
+    void waitAddress(u32* address, u32 expected) {
+        WaitOnAddress(address, &expected, sizeof(u32), INFINITE);
+    }
+    void wakeAddress(u32* address, u32 count) {
+        if (count == 1) WakeByAddressSingle(address);
+        else WakeByAddressAll(address);
+    }
+#elif defined(FR_OS_LINUX)
+    constexpr usize THREAD_CONTROL_SIZE { 64 };
+
+    // Lays out [guard page][stack][thread storage] in one mapping and returns the thread
+    // pointer, with the top of the stack in `stack`. Storage is a copy of the executable's
+    // PT_TLS image placed the way FrogStart does it for the main thread, so code in the
+    // executable finds its thread locals at the offsets the linker chose.
+    static uptr createThreadBlock(
+        usize stack_size, ptr* block, usize* block_size, uptr* stack) {
+        const Elf64_Phdr* headers = (const Elf64_Phdr*)getAuxiliary(AT_PHDR);
+        const usize       count   = getAuxiliary(AT_PHNUM);
+        const Elf64_Phdr* tls     = nullptr;
+        uptr              bias    = 0;
+        for (usize i = 0; i < count; i++) {
+            if (headers[i].p_type == PT_TLS) tls = &headers[i];
+            if (headers[i].p_type == PT_PHDR) bias = (uptr)headers - headers[i].p_vaddr;
+        }
+
+        const usize page   = getAuxiliary(AT_PAGESZ);
+        const usize align  = tls && tls->p_align > 1 ? tls->p_align : 1;
+        const usize image  = tls ? tls->p_memsz + align - 1 & ~(align - 1) : 0;
+        const usize header = align > 16 ? align : 16;
+        const usize area   = image + THREAD_CONTROL_SIZE + header * 2 + page - 1 & ~(page - 1);
+        stack_size         = stack_size + page - 1 & ~(page - 1);
+
+        *block_size = page + stack_size + area;
+        *block      = mapMemory(
+            nullptr, *block_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK);
+        if (!*block) return 0;
+        protectMemory(*block, page, PROT_NONE);
+
+        const uptr storage = (uptr)*block + page + stack_size;
+        *stack             = storage;
+#    if defined(__x86_64__)
+        const uptr thread = storage + image + header - 1 & ~(header - 1);
+        u8*        copy   = (u8*)(thread - image);
+        *(uptr*)thread    = thread;
+#    elif defined(__aarch64__)
+        const uptr thread = storage + header - 1 & ~(header - 1);
+        u8*        copy   = (u8*)(thread + (16 + align - 1 & ~(align - 1)));
+#    endif
+        if (tls) {
+            const u8* source = (const u8*)(tls->p_vaddr + bias);
+            for (usize i = 0; i < tls->p_filesz; i++) copy[i] = source[i];
+        }
+        return thread;
+    }
+
+    bool Thread::start(ThreadFunction _function, ptr _argument, usize stack_size) {
+        if (running) return false;
+        function = _function;
+        argument = _argument;
+
+        if (pthread_create) {
+            running = !pthread_create(
+                &library,
+                nullptr,
+                [](ptr self) -> ptr {
+                    ((Thread*)self)->function(((Thread*)self)->argument);
+                    return nullptr;
+                },
+                this);
+            return running;
+        }
+
+        uptr       stack {};
+        const uptr thread = createThreadBlock(stack_size, &block, &blockSize, &stack);
+        if (!thread) return false;
+
+        constexpr u64 flags = CLONE_VM | CLONE_FS | CLONE_FILES | CLONE_SIGHAND | CLONE_THREAD
+                            | CLONE_SYSVSEM | CLONE_SETTLS | CLONE_PARENT_SETTID
+                            | CLONE_CHILD_CLEARTID;
+        const i64 result = frogClone(flags, (ptr)stack, &id, &id, (ptr)thread, function, argument);
+        if (result < 0) {
+            unmapMemory(block, blockSize);
+            block = nullptr;
+            return false;
+        }
+        running = true;
+        return true;
+    }
+    void Thread::join() {
+        if (!running) return;
+        running = false;
+
+        if (!block) {
+            pthread_join(library, nullptr);
+            return;
+        }
+
+        // The kernel clears the ID and wakes its futex once the thread is gone.
+        u32 current;
+        while ((current = __atomic_load_n(&id, __ATOMIC_ACQUIRE)))
+            systemCall(SYSCALL_FUTEX, (i64)&id, FUTEX_WAIT, current);
+        unmapMemory(block, blockSize);
+        block = nullptr;
+    }
+
+    u32 getCoreCount() {
+        u64       mask[16] {};
+        const i64 written = systemCall(SYSCALL_SCHED_GETAFFINITY, 0, sizeof(mask), (i64)mask);
+
+        // Counted by hand, since __builtin_popcountll may call into libgcc.
+        u32 count = 0;
+        for (i64 i = 0; i < written / (i64)sizeof(u64); i++)
+            for (u64 bits = mask[i]; bits; bits &= bits - 1) count++;
+        return count ? count : 1;
+    }
+    void yieldThread() { systemCall(SYSCALL_SCHED_YIELD); }
+
+    void waitAddress(u32* address, u32 expected) {
+        systemCall(SYSCALL_FUTEX, (i64)address, FUTEX_WAIT_PRIVATE, expected);
+    }
+    void wakeAddress(u32* address, u32 count) {
+        const i64 limit = 0x7F'FF'FF'FF;
+        systemCall(SYSCALL_FUTEX, (i64)address, FUTEX_WAKE_PRIVATE, count > limit ? limit : count);
+    }
+#else
+    bool Thread::start(ThreadFunction _function, ptr _argument, usize stack_size) {
+        if (running) return false;
+        function = _function;
+        argument = _argument;
+
+        pthread_attr_t attributes;
+        pthread_attr_init(&attributes);
+        pthread_attr_setstacksize(&attributes, stack_size);
+        pthread_t thread;
+        running = !pthread_create(
+            &thread,
+            &attributes,
+            [](ptr self) -> ptr {
+                ((Thread*)self)->function(((Thread*)self)->argument);
+                return nullptr;
+            },
+            this);
+        pthread_attr_destroy(&attributes);
+        library = (u64)thread;
+        return running;
+    }
+    void Thread::join() {
+        if (!running) return;
+        running = false;
+        pthread_join((pthread_t)library, nullptr);
+    }
+
+    u32 getCoreCount() {
+        const long count = sysconf(_SC_NPROCESSORS_ONLN);
+        return count > 0 ? (u32)count : 1;
+    }
+    void yieldThread() { sched_yield(); }
+
+    // No futex here, so waiting yields and lets callers re-check.
+    void waitAddress(u32* address, u32 expected) {
+        if (__atomic_load_n(address, __ATOMIC_ACQUIRE) == expected) sched_yield();
+    }
+    void wakeAddress(u32* address, u32 count) { (void)address, (void)count; }
+#endif
+}
@@ -9,11 +9,11 @@
 namespace FrogEngine {
     void Window::startTextInput() {
         textInputEnabled = true;
-        logInfo("%sWINDOW%s: Text Input Activated", FR_LOG_FORMAT_BLUE, FR_LOG_FORMAT_RESET);
+        FR_LOG_INFO(WINDOW, "Text Input Activated");
     }
     void Window::stopTextInput() {
         textInputEnabled = false;
-        logInfo("%sWINDOW%s: Text Input Deactivated", FR_LOG_FORMAT_BLUE, FR_LOG_FORMAT_RESET);
+        FR_LOG_INFO(WINDOW, "Text Input Deactivated");
     }
     void Window::loadTextInput(const char* text, const u32 size) {
         if (size < 1'024) {
@@ -22,18 +22,15 @@ namespace FrogEngine {
             textIndex       = size;
         } else {
             memcpy(textInput, text, 1'024);
-            logWarning(
-                "%sWINDOW%s: New text buffer larger than 1024",
-                FR_LOG_FORMAT_BLUE,
-                FR_LOG_FORMAT_RESET);
+            FR_LOG_WARNING(WINDOW, "New text buffer larger than 1024");
             textInput[1'023] = '\0';
             textIndex        = 1'024;
         }
-        logInfo("%sWINDOW%s: Text Input Loaded", FR_LOG_FORMAT_BLUE, FR_LOG_FORMAT_RESET);
+        FR_LOG_INFO(WINDOW, "Text Input Loaded");
     }
     void Window::clearTextInput() {
         memset(textInput, 0, 1'024);
-        logInfo("%sWINDOW%s: Text Input Cleared", FR_LOG_FORMAT_BLUE, FR_LOG_FORMAT_RESET);
+        FR_LOG_INFO(WINDOW, "Text Input Cleared");
     }
     const Pointer<char> Window::getText() const { return textInput; }
     usize               Window::getTextLength() const { return textIndex; }
@@ -49,10 +46,7 @@ namespace FrogEngine {
         switch (char_character) {
             case '\r': {
                 if (textIndex >= 1'024) {
-                    logWarning(
-                        "%sWINDOW%s: Text input cannot be more than 1024 characters",
-                        FR_LOG_FORMAT_BLUE,
-                        FR_LOG_FORMAT_RESET);
+                    FR_LOG_WARNING(WINDOW, "Text input cannot be more than 1024 characters");
                     break;
                 }
                 textInput[textIndex] = '\n';
@@ -66,10 +60,7 @@ namespace FrogEngine {
             }
             default: {
                 if (textIndex >= 1'024) {
-                    logWarning(
-                        "%sWINDOW%s: Text input cannot be more than 1024 characters",
-                        FR_LOG_FORMAT_BLUE,
-                        FR_LOG_FORMAT_RESET);
+                    FR_LOG_WARNING(WINDOW, "Text input cannot be more than 1024 characters");
                     break;
                 }
                 textInput[textIndex] = char_character;
@@ -9,6 +9,7 @@
 #    include <FrogEngine/Allocator.h>
 #    include <FrogEngine/Log.h>
 #    include <FrogEngine/Pointer.h>
+#    include <FrogEngine/Profile.h>
 #    include <FrogEngine/Window.h>
 
 inline LRESULT CALLBACK windowProc(
@@ -55,37 +56,27 @@ namespace FrogEngine {
     };
 
     Window::Window(Allocator* allocator) {
-        block = allocator->getStaticBlock();
+        block      = allocator->getStaticBlock();
+        frameBlock = allocator->getFrameBlock();
 
-        osWindow  = block->alloc(sizeof(OsWindow));
-        textInput = block->alloc(1'024);
+        osWindow  = block->alloc(sizeof(OsWindow), TAG_WINDOW);
+        textInput = block->alloc(1'024, TAG_WINDOW);
     }
 
     Window::~Window() {
         if (!UnregisterClassA(className, osWindow->hInstance))
-            logError(
-                "%sWINDOW%s: Failed to unregister window class: %lx",
-                FR_LOG_FORMAT_BLUE,
-                FR_LOG_FORMAT_RESET,
-                GetLastError());
-        logInfo("%sWINDOW%s: Window Class Unregistered", FR_LOG_FORMAT_BLUE, FR_LOG_FORMAT_RESET);
+            FR_LOG_ERROR(WINDOW, "Failed to unregister window class: %lx", GetLastError());
+        FR_LOG_INFO(WINDOW, "Window Class Unregistered");
     }
 
     void Window::init(const char* class_name) {
         if (className[0] != 0) {
-            logWarning(
-                "%sWINDOW%s: init() called after initialization",
-                FR_LOG_FORMAT_BLUE,
-                FR_LOG_FORMAT_RESET);
+            FR_LOG_WARNING(WINDOW, "init() called after initialization");
             return;
         }
 
         if (!SetProcessDPIAware())
-            logWarning(
-                "%sWINDOW%s: Failed to set DPI awareness: %lx",
-                FR_LOG_FORMAT_BLUE,
-                FR_LOG_FORMAT_RESET,
-                GetLastError());
+            FR_LOG_WARNING(WINDOW, "Failed to set DPI awareness: %lx", GetLastError());
 
         osWindow->hInstance = GetModuleHandleA(nullptr);
 
@@ -101,37 +92,27 @@ namespace FrogEngine {
 
         HICON icon = LoadIconA(osWindow->hInstance, MAKEINTRESOURCEA(APP_ICON));
         if (!icon)
-            logWarning(
-                "%sWINDOW%s: Failed to load icon: %lu",
-                FR_LOG_FORMAT_BLUE,
-                FR_LOG_FORMAT_RESET,
-                GetLastError());
+            FR_LOG_WARNING(WINDOW, "Failed to load icon: %lu", GetLastError());
         else {
             osWindow->windowClass.hIcon   = icon;
             osWindow->windowClass.hIconSm = icon;
         }
 
-        logInfo("%sWINDOW%s: Window Class Registered", FR_LOG_FORMAT_BLUE, FR_LOG_FORMAT_RESET);
-        logInfo("  Name: %s", className);
+        FR_LOG_INFO(WINDOW, "Window Class Registered");
+        FR_LOG_INFO(WINDOW, "  Name: %s", className);
 
         if (!RegisterClassExA(&osWindow->windowClass))
-            logError(
-                "%sWINDOW%s: Failed to register window class: %lx",
-                FR_LOG_FORMAT_BLUE,
-                FR_LOG_FORMAT_RESET,
-                GetLastError());
+            FR_LOG_ERROR(WINDOW, "Failed to register window class: %lx", GetLastError());
     }
     void Window::open(const WindowInfo* window_info) {
         if (osWindow->hWindow) {
-            logWarning(
-                "%sWINDOW%s: open() called after open", FR_LOG_FORMAT_BLUE, FR_LOG_FORMAT_RESET);
+            FR_LOG_WARNING(WINDOW, "open() called after open");
             return;
         }
 
         if (!window_info) windowInfo = {};
         else windowInfo = *window_info;
-        memcpy(windowTitle, windowInfo.title, 128);
-        windowTitle[127] = 0;
+        formatString(windowTitle, sizeof(windowTitle), "%s", windowInfo.title);
 
         DWORD style { WS_VISIBLE };
 
@@ -145,11 +126,7 @@ namespace FrogEngine {
             case WINDOWED: {
                 style |= WS_OVERLAPPEDWINDOW;
                 if (!AdjustWindowRect(&rect, style, FALSE))
-                    logWarning(
-                        "%sWINDOW%s: Failed to adjust window rect: %lx",
-                        GetLastError(),
-                        FR_LOG_FORMAT_BLUE,
-                        FR_LOG_FORMAT_RESET);
+                    FR_LOG_WARNING(WINDOW, "Failed to adjust window rect: %lx", GetLastError());
                 break;
             }
             case BORDERLESS: {
@@ -165,15 +142,10 @@ namespace FrogEngine {
                 break;
             }
             default:
-                logWarning(
-                    "%sWINDOW%s: Invalid window style", FR_LOG_FORMAT_BLUE, FR_LOG_FORMAT_RESET);
+                FR_LOG_WARNING(WINDOW, "Invalid window style");
                 style |= WS_OVERLAPPEDWINDOW;
                 if (!AdjustWindowRect(&rect, style, FALSE))
-                    logWarning(
-                        "%sWINDOW%s: Failed to adjust window rect: %lx",
-                        FR_LOG_FORMAT_BLUE,
-                        FR_LOG_FORMAT_RESET,
-                        GetLastError());
+                    FR_LOG_WARNING(WINDOW, "Failed to adjust window rect: %lx", GetLastError());
         }
 
         osWindow->hWindow = CreateWindowExA(
@@ -190,15 +162,11 @@ namespace FrogEngine {
             osWindow->hInstance,
             this);
         if (!osWindow->hWindow)
-            logError(
-                "%sWINDOW%s: Failed to create window: %lx",
-                FR_LOG_FORMAT_BLUE,
-                FR_LOG_FORMAT_RESET,
-                GetLastError());
-        logInfo("%sWINDOW%s: Window Created", FR_LOG_FORMAT_BLUE, FR_LOG_FORMAT_RESET);
-        logInfo("  Title: %s", windowTitle);
-        logInfo("  Size: (%i, %i)", window_info->width, window_info->height);
-        logInfo("  Position: (%i, %i)", window_info->x, window_info->y);
+            FR_LOG_ERROR(WINDOW, "Failed to create window: %lx", GetLastError());
+        FR_LOG_INFO(WINDOW, "Window Created");
+        FR_LOG_INFO(WINDOW, "  Title: %s", windowTitle);
+        FR_LOG_INFO(WINDOW, "  Size: (%i, %i)", window_info->width, window_info->height);
+        FR_LOG_INFO(WINDOW, "  Position: (%i, %i)", window_info->x, window_info->y);
 
         GetClientRect(osWindow->hWindow, &rect);
         windowInfo.x      = rect.left;
@@ -208,10 +176,14 @@ namespace FrogEngine {
     }
     void Window::close() const {
         DestroyWindow(osWindow->hWindow);
-        logInfo("%sWINDOW%s: Window Destroyed", FR_LOG_FORMAT_BLUE, FR_LOG_FORMAT_RESET);
+        FR_LOG_INFO(WINDOW, "Window Destroyed");
     }
 
     bool Window::pollEvents() {
+        // A frame ends where the next one polls its events.
+        FR_PROFILE_FRAME();
+        FR_PROFILE_SCOPE("Window::pollEvents");
+        frameBlock->swap();
         if (!IsWindow(osWindow->hWindow)) return false;
 
         MSG msg {};
@@ -236,11 +208,7 @@ namespace FrogEngine {
 
         POINT point;
         if (!GetCursorPos(&point) || !ScreenToClient(osWindow->hWindow, &point))
-            logWarning(
-                "%sWINDOW%s: Failed to get cursor position: %lx",
-                FR_LOG_FORMAT_BLUE,
-                FR_LOG_FORMAT_RESET,
-                GetLastError());
+            FR_LOG_WARNING(WINDOW, "Failed to get cursor position: %lx", GetLastError());
         mouseX = point.x;
         mouseY = point.y;
 
@@ -255,42 +223,29 @@ namespace FrogEngine {
     }
 
     void Window::setWindowTitle(const char* title) {
-        memcpy(windowTitle, title, 128);
-        windowTitle[127] = 0;
+        formatString(windowTitle, sizeof(windowTitle), "%s", title);
         if (!SetWindowTextA(osWindow->hWindow, windowTitle))
-            logWarning(
-                "%sWINDOW%s: Failed to set window title: %lx",
-                GetLastError(),
-                FR_LOG_FORMAT_BLUE,
-                FR_LOG_FORMAT_RESET);
-        logInfo("%sWINDOW%s: Window Title Updated", FR_LOG_FORMAT_BLUE, FR_LOG_FORMAT_RESET);
-        logInfo("  Title: %s", title);
+            FR_LOG_WARNING(WINDOW, "Failed to set window title: %lx", GetLastError());
+        FR_LOG_INFO(WINDOW, "Window Title Updated");
+        FR_LOG_INFO(WINDOW, "  Title: %s", title);
     }
     void Window::setWindowPos(const i32 x, const i32 y) {
         if (!SetWindowPos(
                 osWindow->hWindow, HWND_TOP, x, y, windowInfo.width, windowInfo.height, 0))
-            logWarning(
-                "%sWINDOW%s: Failed to set window pos: %lx",
-                GetLastError(),
-                FR_LOG_FORMAT_BLUE,
-                FR_LOG_FORMAT_RESET);
+            FR_LOG_WARNING(WINDOW, "Failed to set window pos: %lx", GetLastError());
         windowInfo.x = x;
         windowInfo.y = y;
-        logInfo("%sWINDOW%s: Window Position Updated", FR_LOG_FORMAT_BLUE, FR_LOG_FORMAT_RESET);
-        logInfo("  Position: (%i, %i)", windowInfo.x, windowInfo.y);
+        FR_LOG_INFO(WINDOW, "Window Position Updated");
+        FR_LOG_INFO(WINDOW, "  Position: (%i, %i)", windowInfo.x, windowInfo.y);
     }
     void Window::setWindowSize(const i32 width, const i32 height) {
         if (!SetWindowPos(
                 osWindow->hWindow, HWND_TOP, windowInfo.x, windowInfo.y, width, height, 0))
-            logWarning(
-                "%sWINDOW%s: Failed to set window size: %lx",
-                FR_LOG_FORMAT_BLUE,
-                FR_LOG_FORMAT_RESET,
-                GetLastError());
+            FR_LOG_WARNING(WINDOW, "Failed to set window size: %lx", GetLastError());
         windowInfo.width  = width;
         windowInfo.height = height;
-        logInfo("%sWINDOW%s: Window Size Updated", FR_LOG_FORMAT_BLUE, FR_LOG_FORMAT_RESET);
-        logInfo("  Size: (%i, %i)", windowInfo.width, windowInfo.height);
+        FR_LOG_INFO(WINDOW, "Window Size Updated");
+        FR_LOG_INFO(WINDOW, "  Size: (%i, %i)", windowInfo.width, windowInfo.height);
     }
     void Window::setWindowStyle(const WindowStyle window_style) {
         if (windowInfo.style == window_style) return;
@@ -303,11 +258,7 @@ namespace FrogEngine {
         rect.bottom = windowInfo.y + windowInfo.height;
         if (windowInfo.style != FULLSCREEN) {
             if (!GetWindowRect(osWindow->hWindow, &rect)) {
-                logWarning(
-                    "%sWINDOW%s: Failed to get window rect: %lx",
-                    FR_LOG_FORMAT_BLUE,
-                    FR_LOG_FORMAT_RESET,
-                    GetLastError());
+                FR_LOG_WARNING(WINDOW, "Failed to get window rect: %lx", GetLastError());
                 return;
             }
             windowInfo.x      = rect.left;
@@ -331,17 +282,12 @@ namespace FrogEngine {
                 break;
             }
             default:
-                logWarning(
-                    "%sWINDOW%s: Invalid window style", FR_LOG_FORMAT_BLUE, FR_LOG_FORMAT_RESET);
+                FR_LOG_WARNING(WINDOW, "Invalid window style");
                 return;
         }
 
         if (!SetWindowLongPtr(osWindow->hWindow, GWL_STYLE, style))
-            logError(
-                "%sWINDOW%s: Failed to set window style: %lx",
-                FR_LOG_FORMAT_BLUE,
-                FR_LOG_FORMAT_RESET,
-                GetLastError());
+            FR_LOG_ERROR(WINDOW, "Failed to set window style: %lx", GetLastError());
         if (!SetWindowPos(
                 osWindow->hWindow,
                 HWND_TOP,
@@ -350,26 +296,14 @@ namespace FrogEngine {
                 rect.right - rect.left,
                 rect.bottom - rect.top,
                 SWP_FRAMECHANGED | SWP_NOZORDER))
-            logWarning(
-                "%sWINDOW%s: Failed to set window pos: %lx",
-                FR_LOG_FORMAT_BLUE,
-                FR_LOG_FORMAT_RESET,
-                GetLastError());
+            FR_LOG_WARNING(WINDOW, "Failed to set window pos: %lx", GetLastError());
         if (!UpdateWindow(osWindow->hWindow))
-            logWarning(
-                "%sWINDOW%s: Failed to update window: %lx",
-                FR_LOG_FORMAT_BLUE,
-                FR_LOG_FORMAT_RESET,
-                GetLastError());
+            FR_LOG_WARNING(WINDOW, "Failed to update window: %lx", GetLastError());
         if (!InvalidateRect(osWindow->hWindow, nullptr, TRUE))
-            logWarning(
-                "%sWINDOW%s: Failed to invalidate window: %lx",
-                FR_LOG_FORMAT_BLUE,
-                FR_LOG_FORMAT_RESET,
-                GetLastError());
+            FR_LOG_WARNING(WINDOW, "Failed to invalidate window: %lx", GetLastError());
 
         windowInfo.style = window_style;
-        logInfo("%sWINDOW%s: Window Style Updated", FR_LOG_FORMAT_BLUE, FR_LOG_FORMAT_RESET);
+        FR_LOG_INFO(WINDOW, "Window Style Updated");
     }
     const char* Window::getWindowTitle() const { return windowTitle; }
     void        Window::getWindowPos(i32* x, i32* y) const {
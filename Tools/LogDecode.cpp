@@ -0,0 +1,75 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <FrogEngine/Log.h>
+#include <FrogEngine/LogFile.h>
+#include <FrogEngine/Runtime.h>
+
+// frlog-decode [--json] <file>
+//
+// Prints the messages of a log file written after openLogFile(), oldest first. Text lines look
+// like the terminal ones with the time in seconds and the thread in front. --json prints one
+// object per line with the same fields.
+
+using namespace FrogEngine;
+
+static const char* const LEVEL_NAMES[] { "TRACE", "INFO", "WARNING", "ERROR" };
+
+static void printText(const LogEntry* entry, ptr) {
+    char message[LOG_LINE_SIZE];
+    formatCaptured(message, sizeof(message), entry->format, entry->arguments);
+
+    const char* channel = getChannelName(entry->channel);
+    printf("%12.6f ", (f64)entry->time * 1e-9);
+    if (entry->thread == LOG_FILE_NO_THREAD) printf("T-- ");
+    else printf("T%02u ", entry->thread);
+    printf("[%s] %s%s%s\n", LEVEL_NAMES[entry->level], channel, *channel ? ": " : "", message);
+}
+
+static void printJson(const LogEntry* entry, ptr) {
+    char message[LOG_LINE_SIZE];
+    formatCaptured(message, sizeof(message), entry->format, entry->arguments);
+
+    printf(
+        "{\"time\":%.9f,\"thread\":%d,\"level\":\"%s\",\"channel\":\"%s\",\"message\":\"",
+        (f64)entry->time * 1e-9,
+        entry->thread == LOG_FILE_NO_THREAD ? -1 : entry->thread,
+        LEVEL_NAMES[entry->level],
+        getChannelName(entry->channel));
+    for (const char* c = message; *c; c++) {
+        if (*c == '"' || *c == '\\') printf("\\%c", *c);
+        else if ((u8)*c < 0x20) printf("\\u%04x", *c);
+        else putchar(*c);
+    }
+    printf("\"}\n");
+}
+
+int main(int argc, char** argv) {
+    const bool  json = argc == 3 && strcmp(argv[1], "--json") == 0;
+    const char* path = argc == 2 ? argv[1] : json ? argv[2] : nullptr;
+    if (!path) {
+        fprintf(stderr, "usage: frlog-decode [--json] <file>\n");
+        return 2;
+    }
+
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "frlog-decode: can not open %s\n", path);
+        return 1;
+    }
+    fseek(file, 0, SEEK_END);
+    const long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    u8*        data = size > 0 ? (u8*)malloc((usize)size) : nullptr;
+    const bool read = data && fread(data, 1, (usize)size, file) == (usize)size;
+    fclose(file);
+
+    if (!read || !readLogFile(data, (usize)size, json ? printJson : printText, nullptr)) {
+        fprintf(stderr, "frlog-decode: %s is not a log file\n", path);
+        free(data);
+        return 1;
+    }
+    free(data);
+    return 0;
+}